@@ -0,0 +1,1262 @@
+#include "cbuffer.h"
+#include "spsc_cbuffer.h"
+#include "cbuffer_algorithm.h"
+#include "cbuffer_simd.h"
+#include "window_cbuffer.h"
+#include "quantile_cbuffer.h"
+#include "mapped_cbuffer.h"
+#include "mirrored_cbuffer.h"
+#include "record_cbuffer.h"
+#include "cbuffer_pool.h"
+#include "static_cbuffer.h"
+#include "small_cbuffer.h"
+#include "person.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Variabile globale che impedisce al compilatore di
+ * eliminare i cicli misurati
+ */
+volatile long long sink = 0;
+
+/**
+ * @brief Risultato di una misura
+ */
+struct result{
+    std::string suite; ///< gruppo di benchmark
+    std::string container; ///< contenitore misurato
+    std::string type; ///< tipo degli elementi
+    unsigned int capacity; ///< capacità del contenitore
+    std::string operation; ///< operazione misurata
+    double ns; ///< nanosecondi per operazione
+};
+
+std::vector<result> results; ///< risultati raccolti, stampati alla fine in CSV/JSON
+
+/**
+ * @brief Funzione che salva un risultato e lo stampa subito
+ * su stdout in formato CSV (avanzamento)
+ *
+ * @param r risultato da salvare
+ */
+void record(const result &r){
+    results.push_back(r);
+    std::printf("%s,%s,%s,%u,%s,%.3f,%.0f\n", r.suite.c_str(), r.container.c_str(), r.type.c_str(),
+        r.capacity, r.operation.c_str(), r.ns, 1e9 / r.ns);
+    std::fflush(stdout);
+}
+
+/**
+ * @brief Funzione che scrive i risultati in formato CSV
+ *
+ * @param path percorso del file
+ * @return true se il file è stato scritto
+ * @return false altrimenti
+ */
+bool write_csv(const char *path){
+    std::FILE *f = std::fopen(path, "w");
+    if(f == nullptr)
+        return false;
+    std::fprintf(f, "suite,container,type,capacity,operation,ns_per_op,ops_per_sec\n");
+    for(const result &r : results)
+        std::fprintf(f, "%s,%s,%s,%u,%s,%.3f,%.0f\n", r.suite.c_str(), r.container.c_str(), r.type.c_str(),
+            r.capacity, r.operation.c_str(), r.ns, 1e9 / r.ns);
+    return std::fclose(f) == 0;
+}
+
+/**
+ * @brief Funzione che scrive i risultati in formato JSON
+ * (array di oggetti con gli stessi campi del CSV)
+ *
+ * @param path percorso del file
+ * @return true se il file è stato scritto
+ * @return false altrimenti
+ */
+bool write_json(const char *path){
+    std::FILE *f = std::fopen(path, "w");
+    if(f == nullptr)
+        return false;
+    std::fprintf(f, "[\n");
+    for(std::size_t i = 0; i < results.size(); ++i){
+        const result &r = results[i];
+        std::fprintf(f, "  {\"suite\": \"%s\", \"container\": \"%s\", \"type\": \"%s\", \"capacity\": %u, "
+            "\"operation\": \"%s\", \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f}%s\n",
+            r.suite.c_str(), r.container.c_str(), r.type.c_str(), r.capacity, r.operation.c_str(),
+            r.ns, 1e9 / r.ns, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "]\n");
+    return std::fclose(f) == 0;
+}
+
+/**
+ * @brief Funzione che ritorna i nanosecondi impiegati da f
+ *
+ * @tparam F tipo della funzione da misurare
+ * @param f funzione da misurare
+ * @return double nanosecondi trascorsi
+ */
+template<typename F> double elapsed_ns(F f){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+/**
+ * @brief Funzione che ritorna i nanosecondi per operazione
+ * impiegati da f per eseguire ops operazioni
+ *
+ * @tparam F tipo della funzione da misurare
+ * @param f funzione da misurare
+ * @param ops numero di operazioni eseguite da f
+ * @return double nanosecondi per operazione
+ */
+template<typename F> double ns_per_op(F f, long long ops){
+    return elapsed_ns(f) / ops;
+}
+
+/**
+ * @brief Generatore dei valori di prova per il tipo T
+ *
+ * Ogni specializzazione fornisce il nome del tipo, un valore
+ * in funzione di un intero e un checksum che legge l'elemento.
+ *
+ * @tparam T tipo degli elementi
+ */
+template<typename T> struct sample;
+
+/**
+ * @brief Valori di prova di tipo int
+ */
+template<> struct sample<int>{
+    static const char* name(){ return "int"; }
+    static int make(unsigned int i){ return static_cast<int>(i); }
+    static long long checksum(int v){ return v; }
+};
+
+/**
+ * @brief Valori di prova di tipo double
+ */
+template<> struct sample<double>{
+    static const char* name(){ return "double"; }
+    static double make(unsigned int i){ return i * 0.5; }
+    static long long checksum(double v){ return static_cast<long long>(v); }
+};
+
+/**
+ * @brief Valori di prova di tipo std::string (abbastanza lunghi
+ * da non entrare nel buffer interno della stringa)
+ */
+template<> struct sample<std::string>{
+    static const char* name(){ return "std::string"; }
+    static std::string make(unsigned int i){ return "circular buffer value #" + std::to_string(i); }
+    static long long checksum(const std::string &v){ return static_cast<long long>(v.size()); }
+};
+
+/**
+ * @brief Valori di prova di tipo person
+ */
+template<> struct sample<person>{
+    static const char* name(){ return "person"; }
+    static person make(unsigned int i){ return person("Nome" + std::to_string(i), "Cognome" + std::to_string(i)); }
+    static long long checksum(const person &v){ return static_cast<long long>(v.name.size()); }
+};
+
+/**
+ * @brief Adattatore che espone cbuffer<T> al benchmark comparativo
+ *
+ * @tparam T tipo degli elementi
+ */
+template<typename T> struct cbuffer_queue{
+    typedef cbuffer<T> type; ///< contenitore misurato
+
+    static const char* name(){ return "cbuffer"; }
+    static type make(unsigned int capacity){ return type(static_cast<int>(capacity)); }
+    static void push(type &b, const T &value){ b.enqueue(value); }
+    static T pop(type &b){ return b.pop(); }
+    template<typename It> static void push_range(type &b, It first, It last){ b.enqueue_range(first, last); }
+    template<typename OutputIt> static void pop_range(type &b, OutputIt out, unsigned int n){ b.dequeue_into(out, n); }
+
+    /**
+     * @brief Visita gli elementi in ordine FIFO con l'algoritmo segmentato for_each
+     */
+    template<typename F> static void for_each(const type &b, F f){ ::for_each(b, f); }
+};
+
+/**
+ * @brief Adattatore che espone std::deque<T> (riferimento) al
+ * benchmark comparativo. La capacità non limita la deque: il
+ * benchmark non la supera mai.
+ *
+ * @tparam T tipo degli elementi
+ */
+template<typename T> struct deque_queue{
+    typedef std::deque<T> type; ///< contenitore misurato
+
+    static const char* name(){ return "std::deque"; }
+    static type make(unsigned int){ return type(); }
+    static void push(type &d, const T &value){ d.push_back(value); }
+    static T pop(type &d){
+        T value(std::move(d.front()));
+        d.pop_front();
+        return value;
+    }
+    template<typename It> static void push_range(type &d, It first, It last){ d.insert(d.end(), first, last); }
+    template<typename OutputIt> static void pop_range(type &d, OutputIt out, unsigned int n){
+        std::move(d.begin(), d.begin() + n, out);
+        d.erase(d.begin(), d.begin() + n);
+    }
+    template<typename F> static void for_each(const type &d, F f){
+        for(const T &value : d)
+            f(value);
+    }
+};
+
+/**
+ * @brief Benchmark di un contenitore Queue con elementi di tipo T:
+ * enqueue fino alla capacità, iterazione per segmenti e con
+ * iteratori, operator[] ad accesso
+ * casuale, copy constructor, dequeue fino a svuotare e operazioni
+ * in blocco.
+ *
+ * Per le capacità piccole si usano più code per giro, così ogni
+ * intervallo misurato contiene almeno qualche migliaio di operazioni.
+ * I giri si ripetono finché ogni operazione ha almeno min_ops elementi.
+ *
+ * @tparam Queue adattatore del contenitore (cbuffer_queue o deque_queue)
+ * @tparam T tipo degli elementi
+ * @param capacity capacità del contenitore
+ * @param min_ops numero minimo di elementi per operazione
+ */
+template<template<typename> class Queue, typename T> void bench_queue(unsigned int capacity, long long min_ops){
+    typedef Queue<T> Q;
+    typedef typename Q::type queue_type;
+    const unsigned int pool_size = 4096, chunk = std::min(capacity, pool_size);
+    std::vector<T> pool, out(chunk);
+    for(unsigned int i = 0; i < pool_size; ++i)
+        pool.push_back(sample<T>::make(i));
+
+    unsigned int copies = std::max(1u, 4096u / capacity);
+    long long per_round = static_cast<long long>(capacity) * copies;
+    long long rounds = std::max(1LL, min_ops / per_round);
+    std::vector<queue_type> queues;
+    for(unsigned int q = 0; q < copies; ++q)
+        queues.push_back(Q::make(capacity));
+
+    double enqueue = 0, iterate = 0, iterator = 0, random_access = 0, copy = 0, dequeue = 0, bulk = 0;
+    std::uint32_t rng = 2463534242u;
+    for(long long r = 0; r < rounds; ++r){
+        enqueue += elapsed_ns([&](){
+            for(queue_type &q : queues)
+                for(unsigned int i = 0; i < capacity; ++i)
+                    Q::push(q, pool[i & (pool_size - 1)]);
+        });
+
+        iterate += elapsed_ns([&](){
+            long long sum = 0;
+            for(const queue_type &q : queues)
+                Q::for_each(q, [&sum](const T &value){ sum += sample<T>::checksum(value); });
+            sink = sink + sum;
+        });
+
+        iterator += elapsed_ns([&](){
+            long long sum = 0;
+            for(const queue_type &q : queues)
+                for(typename queue_type::const_iterator it = q.begin(), end = q.end(); it != end; ++it)
+                    sum += sample<T>::checksum(*it);
+            sink = sink + sum;
+        });
+
+        random_access += elapsed_ns([&](){
+            long long sum = 0;
+            for(queue_type &q : queues)
+                for(unsigned int i = 0; i < capacity; ++i){
+                    rng ^= rng << 13; // xorshift32
+                    rng ^= rng >> 17;
+                    rng ^= rng << 5;
+                    unsigned int index = static_cast<unsigned int>((static_cast<std::uint64_t>(rng) * capacity) >> 32);
+                    sum += sample<T>::checksum(q[index]);
+                }
+            sink = sink + sum;
+        });
+
+        {
+            std::vector<queue_type> duplicates;
+            duplicates.reserve(copies);
+            copy += elapsed_ns([&](){
+                for(const queue_type &q : queues)
+                    duplicates.emplace_back(q);
+            });
+        }
+
+        dequeue += elapsed_ns([&](){
+            long long sum = 0;
+            for(queue_type &q : queues)
+                for(unsigned int i = 0; i < capacity; ++i)
+                    sum += sample<T>::checksum(Q::pop(q));
+            sink = sink + sum;
+        });
+
+        // blocchi di al più chunk elementi: riempimento con push_range e svuotamento con pop_range
+        bulk += elapsed_ns([&](){
+            for(queue_type &q : queues){
+                for(unsigned int done = 0; done < capacity; done += chunk){
+                    unsigned int n = std::min(chunk, capacity - done);
+                    Q::push_range(q, pool.begin(), pool.begin() + n);
+                }
+                for(unsigned int done = 0; done < capacity; done += chunk)
+                    Q::pop_range(q, out.begin(), std::min(chunk, capacity - done));
+            }
+        });
+    }
+
+    long long ops = rounds * per_round;
+    const char *type = sample<T>::name();
+    record({"queue", Q::name(), type, capacity, "enqueue", enqueue / ops});
+    record({"queue", Q::name(), type, capacity, "iterate", iterate / ops});
+    record({"queue", Q::name(), type, capacity, "iterator", iterator / ops});
+    record({"queue", Q::name(), type, capacity, "operator[]", random_access / ops});
+    record({"queue", Q::name(), type, capacity, "copy_construct", copy / ops});
+    record({"queue", Q::name(), type, capacity, "dequeue", dequeue / ops});
+    record({"queue", Q::name(), type, capacity, "bulk_enqueue_dequeue", bulk / (2 * ops)});
+}
+
+/**
+ * @brief Benchmark di enqueue, pop e operator[] su un cbuffer<int>
+ * con la politica di indicizzazione Index
+ *
+ * @tparam Index politica di indicizzazione
+ * @param name nome della politica
+ * @param capacity capacità della coda
+ * @param ops numero di operazioni
+ */
+template<typename Index> void bench_index(const char *name, unsigned int capacity, long long ops){
+    cbuffer<int, Index> b(capacity);
+    for(unsigned int i = 0; i < b.size(); ++i)
+        b.enqueue(i);
+
+    double enqueue = ns_per_op([&](){ // coda piena: sovrascrittura
+        for(long long i = 0; i < ops; ++i)
+            b.enqueue(static_cast<int>(i));
+    }, ops);
+
+    double pop = ns_per_op([&](){
+        long long sum = 0;
+        for(long long i = 0; i < ops; ++i){
+            sum += b.pop();
+            b.enqueue(static_cast<int>(i));
+        }
+        sink = sink + sum;
+    }, ops);
+
+    double random_access = ns_per_op([&](){
+        long long sum = 0;
+        unsigned int index = 0;
+        for(long long i = 0; i < ops; ++i){
+            sum += b[index];
+            index += 7;
+            if(index >= b.size())
+                index -= b.size();
+        }
+        sink = sink + sum;
+    }, ops);
+
+    std::string container = std::string("cbuffer<") + name + ">";
+    record({"index", container, "int", b.size(), "enqueue_overwrite", enqueue});
+    record({"index", container, "int", b.size(), "pop_enqueue", pop});
+    record({"index", container, "int", b.size(), "operator[]", random_access});
+}
+
+/**
+ * @brief Benchmark di static_cbuffer (capacità N costante, dati
+ * nell'oggetto) con le stesse operazioni di bench_index
+ *
+ * @tparam N capacità della coda
+ * @param ops numero di operazioni
+ */
+template<unsigned int N> void bench_static(long long ops){
+    static static_cbuffer<int, N> b; // statica: N int non stanno necessariamente sullo stack
+    for(unsigned int i = 0; i < N; ++i)
+        b.enqueue(i);
+
+    double enqueue = ns_per_op([&](){
+        for(long long i = 0; i < ops; ++i)
+            b.enqueue(static_cast<int>(i));
+    }, ops);
+
+    double pop = ns_per_op([&](){
+        long long sum = 0;
+        for(long long i = 0; i < ops; ++i){
+            sum += b.pop();
+            b.enqueue(static_cast<int>(i));
+        }
+        sink = sink + sum;
+    }, ops);
+
+    double random_access = ns_per_op([&](){
+        long long sum = 0;
+        unsigned int index = 0;
+        for(long long i = 0; i < ops; ++i){
+            sum += b[index];
+            index += 7;
+            if(index >= N)
+                index -= N;
+        }
+        sink = sink + sum;
+    }, ops);
+
+    record({"index", "static_cbuffer", "int", N, "enqueue_overwrite", enqueue});
+    record({"index", "static_cbuffer", "int", N, "pop_enqueue", pop});
+    record({"index", "static_cbuffer", "int", N, "operator[]", random_access});
+}
+
+/**
+ * @brief Benchmark di enqueue_range/dequeue_into confrontati con
+ * enqueue/pop elemento per elemento su un blocco di samples campioni
+ *
+ * @param samples numero di campioni per blocco
+ * @param rounds numero di ripetizioni
+ */
+void bench_bulk(unsigned int samples, long long rounds){
+    std::vector<int> in(samples, 42), out(samples);
+    cbuffer<int> b(samples);
+    long long ops = rounds * samples;
+
+    double single = ns_per_op([&](){
+        for(long long r = 0; r < rounds; ++r){
+            for(unsigned int i = 0; i < samples; ++i)
+                b.enqueue(in[i]);
+            for(unsigned int i = 0; i < samples; ++i)
+                out[i] = b.pop();
+        }
+    }, ops);
+
+    b.enqueue(0); //testa spostata: i blocchi si dividono in due segmenti
+    double bulk = ns_per_op([&](){
+        for(long long r = 0; r < rounds; ++r){
+            b.enqueue_range(in.begin(), in.end() - 1);
+            b.dequeue_into(out.begin(), samples - 1);
+        }
+    }, ops);
+    sink = sink + out[0];
+
+    record({"bulk", "cbuffer", "int", samples, "enqueue_pop", single});
+    record({"bulk", "cbuffer", "int", samples, "enqueue_range_dequeue_into", bulk});
+}
+
+/**
+ * @brief Benchmark degli algoritmi segmentati (cbuffer_algorithm.h)
+ * confrontati con gli stessi algoritmi della STL sugli iteratori,
+ * su un cbuffer<double> circolare (due segmenti)
+ *
+ * @param capacity capacità della coda
+ * @param rounds numero di ripetizioni
+ */
+void bench_segmented(unsigned int capacity, long long rounds){
+    cbuffer<double> b(capacity);
+    for(unsigned int i = 0; i < capacity + capacity / 3; ++i)
+        b.enqueue(i * 0.5);
+    const cbuffer<double> &cb = b;
+    long long ops = rounds * capacity;
+
+    double iterator_sum = ns_per_op([&](){
+        double sum = 0;
+        for(long long r = 0; r < rounds; ++r)
+            sum += std::accumulate(cb.begin(), cb.end(), 0.0);
+        sink = sink + static_cast<long long>(sum);
+    }, ops);
+    double segmented_sum = ns_per_op([&](){
+        double sum = 0;
+        for(long long r = 0; r < rounds; ++r)
+            sum += accumulate(cb, 0.0);
+        sink = sink + static_cast<long long>(sum);
+    }, ops);
+
+    double iterator_count = ns_per_op([&](){
+        long long n = 0;
+        for(long long r = 0; r < rounds; ++r)
+            n += std::count_if(cb.begin(), cb.end(), [](double x){ return x > 100.0; });
+        sink = sink + n;
+    }, ops);
+    double segmented_count = ns_per_op([&](){
+        long long n = 0;
+        for(long long r = 0; r < rounds; ++r)
+            n += count_if(cb, [](double x){ return x > 100.0; });
+        sink = sink + n;
+    }, ops);
+
+    double iterator_find = ns_per_op([&](){ // valore assente: scansione completa
+        long long n = 0;
+        for(long long r = 0; r < rounds; ++r)
+            n += std::find(cb.begin(), cb.end(), -1.0) - cb.begin();
+        sink = sink + n;
+    }, ops);
+    double segmented_find = ns_per_op([&](){
+        long long n = 0;
+        for(long long r = 0; r < rounds; ++r)
+            n += find(cb, -1.0) - cb.begin();
+        sink = sink + n;
+    }, ops);
+
+    record({"segmented", "cbuffer", "double", capacity, "iterator_accumulate", iterator_sum});
+    record({"segmented", "cbuffer", "double", capacity, "segmented_accumulate", segmented_sum});
+    record({"segmented", "cbuffer", "double", capacity, "iterator_count_if", iterator_count});
+    record({"segmented", "cbuffer", "double", capacity, "segmented_count_if", segmented_count});
+    record({"segmented", "cbuffer", "double", capacity, "iterator_find", iterator_find});
+    record({"segmented", "cbuffer", "double", capacity, "segmented_find", segmented_find});
+}
+
+/**
+ * @brief Benchmark delle riduzioni vettorizzate (cbuffer_simd.h) su un
+ * cbuffer<T> circolare, per ogni livello supportato dalla CPU, confrontate
+ * con l'accumulate segmentato (somma sequenziale)
+ *
+ * @tparam T float o double
+ * @param capacity capacità della coda
+ * @param rounds numero di ripetizioni
+ */
+template<typename T> void bench_simd(unsigned int capacity, long long rounds){
+    const char *type = std::is_same<T, float>::value ? "float" : "double";
+    const char *levels[] = {"scalar", "sse2", "avx2"};
+    cbuffer<T> a(capacity), b(capacity);
+    for(unsigned int i = 0; i < capacity + capacity / 3; ++i){
+        a.enqueue(static_cast<T>(i % 1000) / 10);
+        b.enqueue(static_cast<T>(i % 7));
+    }
+    long long ops = rounds * capacity;
+
+    double naive = ns_per_op([&](){
+        T sum = 0;
+        for(long long r = 0; r < rounds; ++r)
+            sum += accumulate(a, T(0));
+        sink = sink + static_cast<long long>(sum);
+    }, ops);
+    record({"simd", "cbuffer", type, capacity, "accumulate", naive});
+
+    for(int level = simd_scalar; level <= simd_supported(); ++level){
+        simd_set_level(static_cast<simd_level>(level));
+        std::string name = levels[level];
+        double sum = ns_per_op([&](){
+            T s = 0;
+            for(long long r = 0; r < rounds; ++r)
+                s += simd_sum(a);
+            sink = sink + static_cast<long long>(s);
+        }, ops);
+        double min = ns_per_op([&](){
+            T s = 0;
+            for(long long r = 0; r < rounds; ++r)
+                s += simd_min(a) + simd_max(a);
+            sink = sink + static_cast<long long>(s);
+        }, 2 * ops);
+        double dot = ns_per_op([&](){
+            T s = 0;
+            for(long long r = 0; r < rounds; ++r)
+                s += simd_dot(a, b);
+            sink = sink + static_cast<long long>(s);
+        }, ops);
+        record({"simd", "cbuffer", type, capacity, name + "_sum", sum});
+        record({"simd", "cbuffer", type, capacity, name + "_min_max", min});
+        record({"simd", "cbuffer", type, capacity, name + "_dot", dot});
+    }
+    simd_set_level(simd_supported());
+}
+
+/**
+ * @brief Benchmark di enqueue seguito dalla lettura di media, varianza,
+ * minimo e massimo della finestra: window_cbuffer (statistiche
+ * incrementali) confrontato con il ricalcolo su un cbuffer
+ *
+ * @param capacity dimensione della finestra
+ * @param ops numero di campioni per window_cbuffer (il ricalcolo ne usa
+ * al più quanti ne servono per circa 10^8 letture)
+ */
+void bench_window(unsigned int capacity, long long ops){
+    window_cbuffer<double> w(capacity);
+    cbuffer<double> b(capacity);
+    for(unsigned int i = 0; i < capacity; ++i){
+        w.enqueue(i % 100);
+        b.enqueue(i % 100);
+    }
+
+    double incremental = ns_per_op([&](){
+        double s = 0;
+        for(long long i = 0; i < ops; ++i){
+            w.enqueue(static_cast<double>(i % 1000));
+            s += w.mean() + w.variance() + w.min() + w.max();
+        }
+        sink = sink + static_cast<long long>(s);
+    }, ops);
+
+    long long naive_ops = std::max(100LL, std::min(ops, 100000000LL / capacity));
+    double naive = ns_per_op([&](){
+        double s = 0;
+        for(long long i = 0; i < naive_ops; ++i){
+            b.enqueue(static_cast<double>(i % 1000));
+            double sum = 0, squares = 0, lo = b.head(), hi = b.head();
+            for(double x : b){
+                sum += x;
+                squares += x * x;
+                lo = std::min(lo, x);
+                hi = std::max(hi, x);
+            }
+            double mean = sum / b.stored_elements();
+            s += mean + (squares / b.stored_elements() - mean * mean) + lo + hi;
+        }
+        sink = sink + static_cast<long long>(s);
+    }, naive_ops);
+
+    record({"window", "window_cbuffer", "double", capacity, "enqueue_stats", incremental});
+    record({"window", "cbuffer", "double", capacity, "enqueue_recompute_stats", naive});
+}
+
+/**
+ * @brief Benchmark di enqueue seguito dalla lettura di p50, p95 e p99
+ * della finestra: quantile_cbuffer (istogramma logaritmico con errore
+ * relativo dell'1%) confrontato con l'ordinamento di una copia del cbuffer
+ *
+ * @param capacity dimensione della finestra
+ * @param ops numero di campioni per quantile_cbuffer (l'ordinamento ne usa
+ * al più quanti ne servono per circa 10^8 elementi copiati)
+ */
+void bench_quantile(unsigned int capacity, long long ops){
+    quantile_cbuffer<double> w(capacity, log_buckets(1, 1e7, 0.01));
+    cbuffer<double> b(capacity);
+    for(unsigned int i = 0; i < capacity; ++i){
+        w.enqueue(1 + i % 100);
+        b.enqueue(1 + i % 100);
+    }
+
+    double histogram = ns_per_op([&](){
+        double s = 0;
+        for(long long i = 0; i < ops; ++i){
+            w.enqueue(static_cast<double>(1 + (i * 7919) % 100000));
+            s += w.quantile(0.5) + w.quantile(0.95) + w.quantile(0.99);
+        }
+        sink = sink + static_cast<long long>(s);
+    }, ops);
+
+    long long naive_ops = std::max(100LL, std::min(ops, 100000000LL / capacity));
+    std::vector<double> sorted;
+    double naive = ns_per_op([&](){
+        double s = 0;
+        for(long long i = 0; i < naive_ops; ++i){
+            b.enqueue(static_cast<double>(1 + (i * 7919) % 100000));
+            sorted.assign(b.begin(), b.end());
+            std::sort(sorted.begin(), sorted.end());
+            std::size_t n = sorted.size();
+            s += sorted[(n + 1) / 2 - 1] + sorted[(95 * n + 99) / 100 - 1] + sorted[(99 * n + 99) / 100 - 1];
+        }
+        sink = sink + static_cast<long long>(s);
+    }, naive_ops);
+
+    record({"quantile", "quantile_cbuffer", "double", capacity, "enqueue_p50_p95_p99", histogram});
+    record({"quantile", "cbuffer", "double", capacity, "enqueue_sort_p50_p95_p99", naive});
+}
+
+/**
+ * @brief Benchmark di enqueue e pop su mapped_cbuffer (scritture nella
+ * memoria mappata di un file) confrontati con cbuffer, più il costo di
+ * flush() con msync sincrono dopo aver modificato tutte le pagine
+ *
+ * @param capacity dimensione della coda
+ * @param ops numero di operazioni
+ */
+void bench_mapped(unsigned int capacity, long long ops){
+    const char *path = "bench_mapped_cbuffer.bin";
+    std::remove(path);
+    {
+        mapped_cbuffer<int> m(path, capacity);
+        cbuffer<int> b(capacity);
+        for(unsigned int i = 0; i < capacity; ++i){
+            m.enqueue(i);
+            b.enqueue(i);
+        }
+
+        double mapped_enqueue = ns_per_op([&](){ // coda piena: sovrascrittura
+            for(long long i = 0; i < ops; ++i)
+                m.enqueue(static_cast<int>(i));
+        }, ops);
+        double heap_enqueue = ns_per_op([&](){
+            for(long long i = 0; i < ops; ++i)
+                b.enqueue(static_cast<int>(i));
+        }, ops);
+        double mapped_pop = ns_per_op([&](){
+            long long sum = 0;
+            for(long long i = 0; i < ops; ++i){
+                sum += m.pop();
+                m.enqueue(static_cast<int>(i));
+            }
+            sink = sink + sum;
+        }, ops);
+
+        long long rounds = 20;
+        double flush = ns_per_op([&](){
+            for(long long r = 0; r < rounds; ++r){
+                for(unsigned int i = 0; i < capacity; ++i)
+                    m.enqueue(static_cast<int>(r + i));
+                m.flush();
+            }
+        }, rounds);
+
+        record({"mapped", "mapped_cbuffer", "int", capacity, "enqueue", mapped_enqueue});
+        record({"mapped", "cbuffer", "int", capacity, "enqueue", heap_enqueue});
+        record({"mapped", "mapped_cbuffer", "int", capacity, "pop_enqueue", mapped_pop});
+        record({"mapped", "mapped_cbuffer", "int", capacity, "fill_and_flush", flush});
+    }
+    std::remove(path);
+}
+
+/**
+ * @brief Benchmark di accesso su una coda circolare (testa a metà
+ * dell'array): cbuffer confrontato con mirrored_cbuffer, in cui i dati
+ * sono sempre contigui grazie alla doppia mappatura
+ *
+ * @param capacity capacità minima delle code
+ * @param rounds numero di passate su tutta la coda
+ */
+void bench_mirrored(unsigned int capacity, long long rounds){
+    mirrored_cbuffer<int> m(capacity);
+    cbuffer<int> b(m.size());
+    for(unsigned int i = 0; i < m.size() + m.size() / 2; ++i){
+        m.enqueue(i);
+        b.enqueue(i);
+    }
+    const mirrored_cbuffer<int> &cm = m;
+    const cbuffer<int> &cb = b;
+    capacity = m.size();
+    long long ops = rounds * capacity;
+
+    double cbuffer_index = ns_per_op([&](){
+        long long sum = 0;
+        for(long long r = 0; r < rounds; ++r)
+            for(unsigned int i = 0; i < capacity; ++i)
+                sum += cb[i];
+        sink = sink + sum;
+    }, ops);
+    double mirrored_index = ns_per_op([&](){
+        long long sum = 0;
+        for(long long r = 0; r < rounds; ++r)
+            for(unsigned int i = 0; i < capacity; ++i)
+                sum += cm[i];
+        sink = sink + sum;
+    }, ops);
+
+    double cbuffer_iterator = ns_per_op([&](){
+        long long sum = 0;
+        for(long long r = 0; r < rounds; ++r)
+            sum += std::accumulate(cb.begin(), cb.end(), 0LL);
+        sink = sink + sum;
+    }, ops);
+    double mirrored_iterator = ns_per_op([&](){
+        long long sum = 0;
+        for(long long r = 0; r < rounds; ++r)
+            sum += std::accumulate(cm.begin(), cm.end(), 0LL);
+        sink = sink + sum;
+    }, ops);
+
+    std::vector<int> chunk(capacity / 2 + 7, 1);
+    double cbuffer_bulk = ns_per_op([&](){ // i blocchi attraversano il confine dell'array
+        for(long long r = 0; r < rounds; ++r){
+            b.dequeue_into(chunk.begin(), static_cast<unsigned int>(chunk.size()));
+            b.enqueue_range(chunk.begin(), chunk.end());
+        }
+    }, ops);
+    double mirrored_bulk = ns_per_op([&](){
+        for(long long r = 0; r < rounds; ++r){
+            m.dequeue_into(chunk.data(), static_cast<unsigned int>(chunk.size()));
+            m.enqueue_range(chunk.data(), chunk.data() + chunk.size());
+        }
+    }, ops);
+
+    record({"mirrored", "cbuffer", "int", capacity, "operator[]", cbuffer_index});
+    record({"mirrored", "mirrored_cbuffer", "int", capacity, "operator[]", mirrored_index});
+    record({"mirrored", "cbuffer", "int", capacity, "iterator_accumulate", cbuffer_iterator});
+    record({"mirrored", "mirrored_cbuffer", "int", capacity, "iterator_accumulate", mirrored_iterator});
+    record({"mirrored", "cbuffer", "int", capacity, "bulk_dequeue_enqueue", cbuffer_bulk});
+    record({"mirrored", "mirrored_cbuffer", "int", capacity, "bulk_dequeue_enqueue", mirrored_bulk});
+}
+
+/**
+ * @brief Benchmark di righe di log da 40-120 byte: record_cbuffer (record
+ * nell'area di byte, reserve/commit e peek/release senza allocazioni)
+ * confrontato con cbuffer<std::string> (un'allocazione per riga)
+ *
+ * @param bytes dimensione dell'area di record_cbuffer; il cbuffer ha
+ * lo stesso numero medio di righe
+ * @param ops numero di righe scritte e lette
+ */
+void bench_record(unsigned int bytes, long long ops){
+    record_cbuffer<> r(bytes);
+    cbuffer<std::string> b(bytes / 84);
+    char line[128];
+    std::memset(line, 'x', sizeof(line));
+
+    double records = ns_per_op([&](){
+        long long sum = 0;
+        for(long long i = 0; i < ops; ++i){
+            unsigned int n = 40 + static_cast<unsigned int>(i % 81);
+            unsigned char *p = r.reserve(n); // sovrascrive le righe più vecchie
+            std::memcpy(p, line, n);
+            p[0] = static_cast<unsigned char>(i);
+            r.commit(n);
+            if(i % 2 == 1){
+                record_cbuffer<>::const_record head = r.peek();
+                sum += head.second + head.first[0];
+                r.release();
+            }
+        }
+        sink = sink + sum;
+    }, ops);
+
+    double strings = ns_per_op([&](){
+        long long sum = 0;
+        for(long long i = 0; i < ops; ++i){
+            unsigned int n = 40 + static_cast<unsigned int>(i % 81);
+            std::string s(line, n);
+            s[0] = static_cast<char>(i);
+            b.enqueue(std::move(s));
+            if(i % 2 == 1){
+                std::string head = b.pop();
+                sum += head.size() + head[0];
+            }
+        }
+        sink = sink + sum;
+    }, ops);
+
+    record({"record", "record_cbuffer", "bytes", bytes, "write_read_log_line", records});
+    record({"record", "cbuffer", "std::string", bytes / 84, "write_read_log_line", strings});
+}
+
+/**
+ * @brief Benchmark dello svuotamento di una coda circolare piena (con la
+ * testa a metà dell'array) in un file: write_to_fd (un solo writev sui due
+ * segmenti) confrontato con la copia in un buffer contiguo seguita da
+ * write e con una write per elemento
+ *
+ * @param capacity capacità della coda
+ * @param rounds numero di svuotamenti
+ */
+void bench_fd_io(unsigned int capacity, long long rounds){
+    char path[] = "/tmp/cbuffer_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if(fd < 0)
+        return;
+    unlink(path);
+    cbuffer<int> b(capacity);
+    std::vector<int> linear(capacity);
+    auto fill = [&](){
+        lseek(fd, 0, SEEK_SET);
+        for(unsigned int i = 0; i < capacity + capacity / 2; ++i)
+            b.enqueue(static_cast<int>(i));
+    };
+
+    double writev_ns = ns_per_op([&](){
+        for(long long r = 0; r < rounds; ++r){
+            fill();
+            b.write_to_fd(fd);
+        }
+    }, rounds * capacity);
+
+    double copy_ns = ns_per_op([&](){
+        for(long long r = 0; r < rounds; ++r){
+            fill();
+            unsigned int n = 0;
+            while(!b.is_empty())
+                linear[n++] = b.pop();
+            if(write(fd, linear.data(), n * sizeof(int)) < 0)
+                return;
+        }
+    }, rounds * capacity);
+
+    double element_ns = ns_per_op([&](){
+        for(long long r = 0; r < rounds; ++r){
+            fill();
+            while(!b.is_empty()){
+                int value = b.pop();
+                if(write(fd, &value, sizeof(value)) < 0)
+                    return;
+            }
+        }
+    }, rounds * capacity);
+    close(fd);
+
+    record({"fd_io", "cbuffer", "int", capacity, "write_to_fd", writev_ns});
+    record({"fd_io", "cbuffer", "int", capacity, "copy_then_write", copy_ns});
+    record({"fd_io", "cbuffer", "int", capacity, "write_per_element", element_ns});
+}
+
+/**
+ * @brief Benchmark della creazione e distruzione di code di breve durata
+ * (una finestra per connessione): std::allocator confrontato con
+ * pool_allocator e con std::pmr::polymorphic_allocator su un block_pool
+ *
+ * @param capacity capacità delle code
+ * @param rounds numero di code create
+ */
+void bench_allocator(unsigned int capacity, long long rounds){
+    auto churn = [capacity, rounds](auto make){
+        return ns_per_op([&](){
+            long long sum = 0;
+            for(long long r = 0; r < rounds; ++r){
+                auto b = make();
+                for(int i = 0; i < 16; ++i)
+                    b.enqueue(i);
+                sum += b.head() + static_cast<long long>(b.stored_elements());
+            }
+            sink = sink + sum;
+        }, rounds);
+    };
+    block_pool pool;
+
+    double standard = churn([capacity](){
+        return cbuffer<int>(capacity);
+    });
+    double pooled = churn([capacity](){
+        return cbuffer<int, modulo_index, overwrite_on_full, pool_allocator<int>>(capacity);
+    });
+    double pmr = churn([capacity, &pool](){
+        return cbuffer<int, modulo_index, overwrite_on_full, std::pmr::polymorphic_allocator<int>>(capacity, &pool);
+    });
+
+    record({"allocator", "std::allocator", "int", capacity, "create_destroy", standard});
+    record({"allocator", "pool_allocator", "int", capacity, "create_destroy", pooled});
+    record({"allocator", "pmr_block_pool", "int", capacity, "create_destroy", pmr});
+}
+
+/**
+ * @brief Benchmark di clear su una coda piena di int: clear (distruzione
+ * degli elementi, nulla per un tipo banale, e azzeramento dei contatori)
+ * confrontato con la riallocazione dell'array (nuova coda della stessa
+ * capacità). Viene misurata solo l'operazione, non il riempimento, e
+ * dal tempo viene sottratto quello della lettura dell'orologio.
+ *
+ * @param capacity capacità della coda
+ * @param rounds numero di svuotamenti
+ */
+void bench_clear(unsigned int capacity, long long rounds){
+    std::vector<int> values(capacity);
+    for(unsigned int i = 0; i < capacity; ++i)
+        values[i] = static_cast<int>(i);
+    cbuffer<int> b(capacity);
+    double clear_ns = 0, reallocate_ns = 0, clock_ns = 0;
+    for(long long r = 0; r < rounds; ++r){
+        clock_ns += elapsed_ns([](){});
+        b.enqueue_range(values.begin(), values.end());
+        clear_ns += elapsed_ns([&](){ b.clear(); });
+        b.enqueue_range(values.begin(), values.end());
+        reallocate_ns += elapsed_ns([&](){ b = cbuffer<int>(capacity); });
+    }
+    sink = sink + b.stored_elements();
+
+    record({"clear", "cbuffer", "int", capacity, "clear_full", std::max(clear_ns - clock_ns, 0.0) / rounds});
+    record({"clear", "cbuffer", "int", capacity, "reallocate_full", std::max(reallocate_ns - clock_ns, 0.0) / rounds});
+}
+
+/**
+ * @brief Benchmark di small_cbuffer<int, 32> con capacità entro K (dati
+ * nell'oggetto) confrontato con cbuffer<int>: creazione con 16 inserimenti
+ * e distruzione, e somma con operator[] su un vettore di code
+ *
+ * @param capacity capacità delle code (<= 32)
+ * @param rounds numero di code create
+ */
+void bench_small(unsigned int capacity, long long rounds){
+    auto churn = [capacity, rounds](auto make){
+        return ns_per_op([&](){
+            long long sum = 0;
+            for(long long r = 0; r < rounds; ++r){
+                auto b = make();
+                for(int i = 0; i < 16; ++i)
+                    b.enqueue(i);
+                sum += b.head() + b[b.stored_elements() - 1];
+            }
+            sink = sink + sum;
+        }, rounds);
+    };
+    auto scan = [capacity, rounds](auto make){
+        const unsigned int queues = 4096; // le code non stanno tutte in L1
+        std::vector<decltype(make())> v;
+        v.reserve(queues);
+        for(unsigned int q = 0; q < queues; ++q){
+            v.push_back(make());
+            for(unsigned int i = 0; i < capacity; ++i)
+                v.back().enqueue(static_cast<int>(q + i));
+        }
+        long long reads = rounds * 16;
+        return ns_per_op([&](){
+            long long sum = 0;
+            unsigned int q = 0;
+            for(long long r = 0; r < reads; ++r){
+                sum += v[q][r % capacity];
+                q = (q + 97) % queues;
+            }
+            sink = sink + sum;
+        }, reads);
+    };
+
+    double heap_churn = churn([capacity](){ return cbuffer<int>(capacity); });
+    double small_churn = churn([capacity](){ return small_cbuffer<int, 32>(capacity); });
+    double heap_scan = scan([capacity](){ return cbuffer<int>(capacity); });
+    double small_scan = scan([capacity](){ return small_cbuffer<int, 32>(capacity); });
+
+    record({"small", "cbuffer", "int", capacity, "create_destroy", heap_churn});
+    record({"small", "small_cbuffer<32>", "int", capacity, "create_destroy", small_churn});
+    record({"small", "cbuffer", "int", capacity, "operator[]_many_queues", heap_scan});
+    record({"small", "small_cbuffer<32>", "int", capacity, "operator[]_many_queues", small_scan});
+}
+
+/**
+ * @brief Benchmark di una FIFO illimitata: ops inserimenti (uno ogni
+ * quattro seguito da un'estrazione) con cbuffer grow_on_full, con
+ * std::deque e con un cbuffer ingrandito a mano copiando gli elementi
+ * in una coda di capacità doppia quando è piena
+ *
+ * @param ops numero di inserimenti
+ */
+void bench_grow(long long ops){
+    auto fifo = [ops](auto b){
+        return ns_per_op([&](){
+            long long sum = 0;
+            for(long long i = 0; i < ops; ++i){
+                b.enqueue(static_cast<int>(i));
+                if(i % 4 == 3)
+                    sum += b.pop();
+            }
+            sink = sink + sum + b.stored_elements();
+        }, ops);
+    };
+    double grow = fifo(cbuffer<int, modulo_index, grow_on_full>());
+    double grow_pow2 = fifo(cbuffer<int, pow2_index, grow_on_full>());
+
+    double deque = ns_per_op([&](){
+        std::deque<int> d;
+        long long sum = 0;
+        for(long long i = 0; i < ops; ++i){
+            d.push_back(static_cast<int>(i));
+            if(i % 4 == 3){
+                sum += d.front();
+                d.pop_front();
+            }
+        }
+        sink = sink + sum + d.size();
+    }, ops);
+
+    double copy = ns_per_op([&](){
+        cbuffer<int> b(1);
+        long long sum = 0;
+        for(long long i = 0; i < ops; ++i){
+            if(b.is_full()){
+                cbuffer<int> bigger(b.size() * 2);
+                for(cbuffer<int>::const_iterator it = b.begin(); it != b.end(); ++it)
+                    bigger.enqueue(*it);
+                b = std::move(bigger);
+            }
+            b.enqueue(static_cast<int>(i));
+            if(i % 4 == 3)
+                sum += b.pop();
+        }
+        sink = sink + sum + b.stored_elements();
+    }, ops);
+
+    record({"grow", "cbuffer<modulo,grow_on_full>", "int", 0, "unbounded_fifo", grow});
+    record({"grow", "cbuffer<pow2,grow_on_full>", "int", 0, "unbounded_fifo", grow_pow2});
+    record({"grow", "std::deque", "int", 0, "unbounded_fifo", deque});
+    record({"grow", "cbuffer_copy_into_larger", "int", 0, "unbounded_fifo", copy});
+}
+
+/**
+ * @brief Funzione che fissa il thread corrente sul core cpu
+ * (modulo il numero di core disponibili). Non fa nulla
+ * sui sistemi diversi da Linux.
+ *
+ * @param cpu indice del core
+ */
+void pin_thread(unsigned int cpu){
+#ifdef __linux__
+    unsigned int cores = std::thread::hardware_concurrency();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cores > 0 ? cpu % cores : 0, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+/**
+ * @brief Benchmark produttore/consumatore su due thread fissati su core
+ * diversi: spsc_cbuffer confrontato con un cbuffer protetto da mutex
+ *
+ * @param capacity capacità della coda
+ * @param ops numero di elementi trasferiti
+ */
+void bench_spsc(unsigned int capacity, long long ops){
+    spsc_cbuffer<long long> lock_free(capacity);
+    double spsc = ns_per_op([&](){
+        std::thread producer([&](){
+            pin_thread(1);
+            for(long long i = 0; i < ops; ++i)
+                while(!lock_free.try_enqueue(i))
+                    std::this_thread::yield();
+        });
+        pin_thread(0);
+        long long value = 0, sum = 0;
+        for(long long i = 0; i < ops; ++i){
+            while(!lock_free.try_dequeue(value))
+                std::this_thread::yield();
+            sum += value;
+        }
+        producer.join();
+        sink = sink + sum;
+    }, ops);
+
+    cbuffer<long long> locked(capacity);
+    std::mutex m;
+    double mutex = ns_per_op([&](){
+        std::thread producer([&](){
+            pin_thread(1);
+            for(long long i = 0; i < ops; ){
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    if(!locked.is_full()){
+                        locked.enqueue(i);
+                        ++i;
+                        continue;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        });
+        pin_thread(0);
+        long long sum = 0;
+        for(long long i = 0; i < ops; ){
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if(!locked.is_empty()){
+                    sum += locked.pop();
+                    ++i;
+                    continue;
+                }
+            }
+            std::this_thread::yield();
+        }
+        producer.join();
+        sink = sink + sum;
+    }, ops);
+
+    record({"spsc", "spsc_cbuffer", "long long", capacity, "transfer", spsc});
+    record({"spsc", "mutex_cbuffer", "long long", capacity, "transfer", mutex});
+}
+
+/**
+ * @brief Esegue il benchmark comparativo cbuffer/std::deque per il tipo T
+ * sulle capacità 16, 256, ..., max_capacity (potenze di 16)
+ *
+ * @tparam T tipo degli elementi
+ * @param max_capacity capacità massima
+ * @param min_ops numero minimo di elementi per operazione
+ */
+template<typename T> void bench_type(unsigned int max_capacity, long long min_ops){
+    for(unsigned int capacity = 16; capacity <= max_capacity; capacity *= 16){
+        bench_queue<deque_queue, T>(capacity, min_ops);
+        bench_queue<cbuffer_queue, T>(capacity, min_ops);
+        if(capacity > max_capacity / 16)
+            break;
+    }
+}
+
+/**
+ * @brief Stampa su stderr le opzioni del programma
+ *
+ * @param program nome dell'eseguibile
+ */
+void usage(const char *program){
+    std::fprintf(stderr, "usage: %s [--csv FILE] [--json FILE] [--max-capacity N] [--min-ops N] [--quick]\n", program);
+}
+
+int main(int argc, char *argv[]){
+    const char *csv = nullptr, *json = nullptr;
+    unsigned int max_capacity = 1u << 24; // 16M
+    long long min_ops = 1LL << 21, scale = 1;
+    for(int i = 1; i < argc; ++i){
+        bool has_value = i + 1 < argc;
+        if(std::strcmp(argv[i], "--csv") == 0 && has_value)
+            csv = argv[++i];
+        else if(std::strcmp(argv[i], "--json") == 0 && has_value)
+            json = argv[++i];
+        else if(std::strcmp(argv[i], "--max-capacity") == 0 && has_value)
+            max_capacity = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else if(std::strcmp(argv[i], "--min-ops") == 0 && has_value)
+            min_ops = std::strtoll(argv[++i], nullptr, 10);
+        else if(std::strcmp(argv[i], "--quick") == 0){
+            max_capacity = 1u << 16;
+            min_ops = 1LL << 18;
+            scale = 10;
+        }else{
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if(min_ops < 1)
+        min_ops = 1;
+
+    std::printf("suite,container,type,capacity,operation,ns_per_op,ops_per_sec\n");
+    bench_type<int>(max_capacity, min_ops);
+    bench_type<double>(max_capacity, min_ops);
+    bench_type<std::string>(max_capacity, min_ops);
+    bench_type<person>(max_capacity, min_ops);
+
+    const long long ops = 50000000 / scale;
+    bench_index<modulo_index>("modulo", 1024, ops);
+    bench_index<pow2_index>("pow2", 1024, ops);
+    bench_index<modulo_index>("modulo", 1000, ops);
+    bench_static<1024>(ops);
+    bench_static<1000>(ops);
+    bench_index<modulo_index>("modulo", 1 << 20, ops);
+    bench_index<pow2_index>("pow2", 1 << 20, ops);
+    bench_bulk(65536, 2000 / scale);
+    bench_segmented(1 << 20, 200 / scale);
+    bench_simd<double>(1 << 14, 20000 / scale); // dati in cache
+    bench_simd<float>(1 << 14, 20000 / scale);
+    bench_simd<double>(1 << 22, 50 / scale); // dati in memoria
+    for(unsigned int capacity = 64; capacity <= 65536; capacity *= 32)
+        bench_window(capacity, 10000000 / scale);
+    for(unsigned int capacity = 64; capacity <= 65536; capacity *= 32)
+        bench_quantile(capacity, 10000000 / scale);
+    bench_mapped(1 << 20, 50000000 / scale);
+    bench_mirrored(1 << 16, 2000 / scale);
+    bench_record(1 << 16, 20000000 / scale);
+    bench_fd_io(1 << 16, 20 / scale);
+    for(unsigned int capacity = 64; capacity <= 65536; capacity *= 32)
+        bench_allocator(capacity, 5000000 / scale);
+    bench_clear(64, 100000 / scale);
+    bench_clear(4096, 10000 / scale);
+    bench_clear(1 << 20, 100 / scale);
+    bench_small(16, 5000000 / scale);
+    bench_grow(20000000 / scale);
+    bench_spsc(1024, 20000000 / scale);
+
+    if(csv != nullptr && !write_csv(csv)){
+        std::fprintf(stderr, "cannot write %s\n", csv);
+        return 1;
+    }
+    if(json != nullptr && !write_json(json)){
+        std::fprintf(stderr, "cannot write %s\n", json);
+        return 1;
+    }
+    return 0;
+}
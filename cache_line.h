@@ -0,0 +1,12 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+/**
+ * @brief Dimensione in byte di una linea di cache, usata per separare
+ * i dati scritti da thread diversi (evita il false sharing).
+ * Può essere ridefinita in compilazione con -DCBUFFER_CACHE_LINE=...
+ */
+#ifndef CBUFFER_CACHE_LINE
+#define CBUFFER_CACHE_LINE 64
+#endif
+
+#endif
@@ -3,240 +3,1635 @@
 #include <algorithm>
 #include <ostream>
 #include <cassert>
-#include <math.h> 
 #include <iostream>
-#include <iterator> // std::random_iterator_tag
+#include <iterator> // std::random_access_iterator_tag
 #include <cstddef> // std::ptrdiff_t
+#include <new> // placement new, std::align_val_t
+#include <utility> // std::move, std::forward
+#include <memory> // std::uninitialized_copy, std::destroy_n, std::allocator_traits
+#include <type_traits> // std::is_same, std::is_trivially_copyable, std::is_trivially_destructible
+#include <optional>
+#include <limits> // std::numeric_limits
+#include <stdexcept> // std::out_of_range, std::length_error
 #include "negative_queue_size_exception.h"
 #include "empty_queue_exception.h"
+#include "cbuffer_index.h"
+#include "cbuffer_overflow.h"
+
+/**
+ * @brief Definita sui sistemi POSIX, dove sono disponibili write_to_fd e
+ * read_from_fd (writev/readv sui segmenti contigui della coda)
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#define CBUFFER_POSIX_IO
+#include <cerrno>
+#include <system_error>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Attributo per le funzioni che lanciano eccezioni: le tiene
+ * fuori linea in modo che i metodi chiamanti restino piccoli e inlineabili
+ */
+#if defined(__GNUC__)
+#define CBUFFER_COLD __attribute__((noinline, cold))
+#else
+#define CBUFFER_COLD
+#endif
+
+/**
+ * @brief Numero di elementi che un cbuffer con allocatore Allocator salva
+ * nell'oggetto invece che sullo heap: Allocator::inline_capacity se
+ * l'allocatore lo dichiara (vedi small_buffer_allocator), altrimenti 0
+ *
+ * @tparam Allocator allocatore del cbuffer
+ */
+template<typename Allocator, typename = void> struct cbuffer_inline_capacity{
+    static constexpr unsigned int value = 0;
+};
+
+template<typename Allocator> struct cbuffer_inline_capacity<Allocator, std::void_t<decltype(Allocator::inline_capacity)>>{
+    static constexpr unsigned int value = Allocator::inline_capacity;
+};
+
+/**
+ * @brief Area non inizializzata per K elementi di tipo T salvata
+ * nell'oggetto che la contiene
+ *
+ * @tparam T tipo degli elementi
+ * @tparam K numero di elementi
+ */
+template<typename T, unsigned int K> struct cbuffer_inline_storage{
+    alignas(T) unsigned char bytes[K * sizeof(T)]; ///< slot non inizializzati
+
+    T* data() noexcept{
+        return reinterpret_cast<T*>(bytes);
+    }
+
+    const T* data() const noexcept{
+        return reinterpret_cast<const T*>(bytes);
+    }
+};
+
+/**
+ * @brief Specializzazione senza slot nell'oggetto (classe vuota)
+ */
+template<typename T> struct cbuffer_inline_storage<T, 0>{
+    T* data() noexcept{
+        return nullptr;
+    }
+
+    const T* data() const noexcept{
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Classe cbuffer_iterator
+ * Iteratore ad accesso casuale sui dati contenuti in una coda circolare,
+ * condiviso da cbuffer e static_cbuffer. La posizione è la distanza logica
+ * dalla testa (0 = head, stored_elements() = end), quindi aritmetica e
+ * confronti sono operazioni intere in O(1); lo slot nell'array viene
+ * calcolato dalla coda (at_offset) solo al dereferenziamento.
+ * Inserimenti e rimozioni invalidano gli iteratori.
+ *
+ * @tparam Container tipo della coda (const per const_iterator)
+ * @tparam V T per iterator, const T per const_iterator
+ */
+template<typename Container, typename V> class cbuffer_iterator{
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename std::remove_const<V>::type value_type;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef V*                              pointer;
+        typedef V&                              reference;
+
+        /**
+         * @brief Costruttore di default
+         *
+         */
+        constexpr cbuffer_iterator() : _cbuffer(nullptr), _offset(0){}
+
+        /**
+         * @brief Conversione da iterator a const_iterator
+         *
+         * @param other iteratore da convertire
+         */
+        template<typename C, typename W, typename = typename std::enable_if<
+            std::is_same<const C, Container>::value && std::is_same<const W, V>::value && !std::is_const<W>::value>::type>
+        constexpr cbuffer_iterator(const cbuffer_iterator<C, W> &other) : _cbuffer(other._cbuffer), _offset(other._offset){}
+
+        /**
+         * @brief Operatore*
+         * @return reference al dato riferito dall'iteratore (dereferenziamento)
+         */
+        constexpr reference operator*() const {
+            return _cbuffer->at_offset(static_cast<unsigned int>(_offset));
+        }
+
+        /**
+         * @brief Operatore->
+         *
+         * @return puntatore al dato riferito dall'iteratore
+         */
+        constexpr pointer operator->() const {
+            return &**this;
+        }
+
+        /**
+         * @brief Operatore di accesso random
+         *
+         * @param index distanza dall'iteratore corrente
+         * @return reference riferimento del valore in posizione index
+         */
+        constexpr reference operator[](difference_type index) const {
+            return *(*this + index);
+        }
+
+        /**
+        * @brief Operatore++ di post-incremento
+        * @return copia dell'iteratore che punta al valore precedente
+        */
+        constexpr cbuffer_iterator operator++(int) {
+            cbuffer_iterator tmp(*this);
+            ++_offset;
+            return tmp;
+        }
+
+        /**
+         * @brief Operatore++ pre-incremento
+         * @return reference all'teratore this
+         */
+        constexpr cbuffer_iterator& operator++() {
+            ++_offset;
+            return *this;
+        }
+
+        /**
+         * @brief Operatore di iterazione post-decremento
+         *
+         * @return cbuffer_iterator copia dell'iteratore prima del decremento
+         */
+        constexpr cbuffer_iterator operator--(int) {
+            cbuffer_iterator tmp(*this);
+            --_offset;
+            return tmp;
+        }
+
+        /**
+         * @brief Operatore di iterazione pre-decremento
+         *
+         * @return cbuffer_iterator& reference iteratore corrente
+         */
+        constexpr cbuffer_iterator& operator--() {
+            --_offset;
+            return *this;
+        }
+
+        /**
+         * @brief Spostamento in avanti
+         *
+         * @param offset scostamento
+         * @return cbuffer_iterator iteratore che punta al nuovo dato
+         */
+        constexpr cbuffer_iterator operator+(difference_type offset) const {
+            return cbuffer_iterator(_cbuffer, _offset + offset);
+        }
+
+        /**
+         * @brief Spostamento in avanti (offset + iteratore)
+         *
+         * @param offset scostamento
+         * @param it iteratore
+         * @return cbuffer_iterator iteratore che punta al nuovo dato
+         */
+        friend constexpr cbuffer_iterator operator+(difference_type offset, const cbuffer_iterator &it) {
+            return it + offset;
+        }
+
+        /**
+         * @brief Spostamento all'indietro
+         *
+         * @param offset scostamento
+         * @return cbuffer_iterator iteratore che punta al nuovo dato
+         */
+        constexpr cbuffer_iterator operator-(difference_type offset) const {
+            return cbuffer_iterator(_cbuffer, _offset - offset);
+        }
+
+        /**
+         * @brief Spostamento in avanti
+         *
+         * @param offset scostamento
+         * @return cbuffer_iterator& iteratore corrente che punta al nuovo dato
+         */
+        constexpr cbuffer_iterator& operator+=(difference_type offset) {
+            _offset += offset;
+            return *this;
+        }
+
+        /**
+         * @brief Spostamento all'indietro
+         *
+         * @param offset scostamento
+         * @return cbuffer_iterator& iteratore corrente che punta al nuovo dato
+         */
+        constexpr cbuffer_iterator& operator-=(difference_type offset) {
+            _offset -= offset;
+            return *this;
+        }
+
+        /**
+         * @brief Numero di elementi tra due iteratori. Gli operatori
+         * binari sono friend, così un iterator può essere confrontato
+         * con un const_iterator (viene convertito).
+         *
+         * @param a iteratore a
+         * @param b iteratore b (sulla stessa coda)
+         * @return difference_type distanza tra b e a
+         */
+        friend constexpr difference_type operator-(const cbuffer_iterator &a, const cbuffer_iterator &b) {
+            return a._offset - b._offset;
+        }
+
+        /**
+         * @brief Operatore==
+         *
+         * @param a iteratore a
+         * @param b iteratore b
+         * @return true se a e b puntano allo stesso dato
+         * @return false se a e b non puntano allo stesso dato
+         */
+        friend constexpr bool operator==(const cbuffer_iterator &a, const cbuffer_iterator &b) {
+            return a._offset == b._offset;
+        }
+
+        /**
+         * @brief Operatore!=
+         *
+         * @param a iteratore a
+         * @param b iteratore b
+         * @return true se a e b non puntano allo stesso dato
+         * @return false se a e b puntano allo stesso dato
+         */
+        friend constexpr bool operator!=(const cbuffer_iterator &a, const cbuffer_iterator &b) {
+            return a._offset != b._offset;
+        }
+
+        /**
+         * @brief Operatore di confronto
+         *
+         * @param a iteratore a
+         * @param b iteratore b
+         * @return true se a è > di b
+         * @return false altrimenti
+         */
+        friend constexpr bool operator>(const cbuffer_iterator &a, const cbuffer_iterator &b) {
+            return a._offset > b._offset;
+        }
+
+        /**
+         * @brief Operatore di confronto
+         *
+         * @param a iteratore a
+         * @param b iteratore b
+         * @return true se a è >= di b
+         * @return false altrimenti
+         */
+        friend constexpr bool operator>=(const cbuffer_iterator &a, const cbuffer_iterator &b) {
+            return a._offset >= b._offset;
+        }
+
+        /**
+         * @brief Operatore di confronto
+         *
+         * @param a iteratore a
+         * @param b iteratore b
+         * @return true se a è < di b
+         * @return false altrimenti
+         */
+        friend constexpr bool operator<(const cbuffer_iterator &a, const cbuffer_iterator &b) {
+            return a._offset < b._offset;
+        }
+
+        /**
+         * @brief Operatore di confronto
+         *
+         * @param a iteratore a
+         * @param b iteratore b
+         * @return true se a è <= di b
+         * @return false altrimenti
+         */
+        friend constexpr bool operator<=(const cbuffer_iterator &a, const cbuffer_iterator &b) {
+            return a._offset <= b._offset;
+        }
+
+    private:
+        friend typename std::remove_const<Container>::type;///< la coda crea gli iteratori
+        template<typename C, typename W> friend class cbuffer_iterator;///< conversione a const_iterator
+        Container *_cbuffer;///< puntatore alla coda corrente
+        difference_type _offset;///< distanza logica dalla testa
+
+        /**
+         * @brief Costruttore privato
+         *
+         * @param q puntatore alla coda
+         * @param offset distanza logica dalla testa
+         */
+        constexpr cbuffer_iterator(Container *q, difference_type offset)
+            : _cbuffer(q), _offset(offset){}
+};
+
 /**
  * @brief Classe cbuffer
  * 
  * La classe implementa una generica coda circolare
  * 
  * @tparam T Tipo degli elementi contenuti nella coda
+ * @tparam Index Politica di indicizzazione (modulo_index o pow2_index)
+ * @tparam Overflow Politica di inserimento su coda piena (overwrite_on_full, reject_on_full
+ * o grow_on_full)
+ * @tparam Allocator Allocatore dell'array (compatibile con std::allocator, ad esempio
+ * std::pmr::polymorphic_allocator o pool_allocator); fornisce solo la memoria,
+ * gli elementi sono costruiti in loco dalla coda. Con small_buffer_allocator
+ * le code di capacità fino a inline_capacity salvano i dati nell'oggetto.
  */
-template<typename T> class cbuffer{
+template<typename T, typename Index = modulo_index, typename Overflow = overwrite_on_full,
+    typename Allocator = std::allocator<T>> class cbuffer{
+
+    static_assert(!std::is_same<Overflow, block_on_full>::value,
+        "block_on_full is only supported by the concurrent queues (spsc_cbuffer, mpmc_cbuffer)");
+
+    static const bool rejects = std::is_same<Overflow, reject_on_full>::value; ///< true se la coda piena rifiuta gli inserimenti
+    static const bool grows = std::is_same<Overflow, grow_on_full>::value; ///< true se la coda piena aumenta la capacità
+
+    typedef std::allocator_traits<typename std::allocator_traits<Allocator>::template rebind_alloc<T>> alloc_traits;
+
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value,
+        "cbuffer requires an allocator whose pointer type is T*");
 
-    int _head; ///< indice della testa
-    int _tail; ///< indice della coda
+    unsigned int _head; ///< contatore della testa (la posizione nell'array è data da Index::slot)
     unsigned int _size; ///< dimensione massima della coda
     unsigned int _stored_elements; ///< numero di elementi salvati
-    T *_queue; ///< puntatore all'array in cui sono salvati i dati
+    T *_queue; ///< puntatore all'area di memoria (non inizializzata) in cui sono salvati i dati
+    [[no_unique_address]] typename alloc_traits::allocator_type _allocator; ///< allocatore dell'array
+
+    static constexpr unsigned int inline_capacity = cbuffer_inline_capacity<Allocator>::value; ///< capacità massima con i dati nell'oggetto
+
+    [[no_unique_address]] cbuffer_inline_storage<T, inline_capacity> _inline; ///< slot nell'oggetto (vuoto se inline_capacity == 0)
+
+    /**
+     * @brief Funzione di supporto che ritorna l'inizio dell'array dei dati.
+     * Con capacità fino a inline_capacity i dati sono sempre negli slot
+     * nell'oggetto (vedi allocate), quindi il loro indirizzo viene calcolato
+     * da this invece di caricare _queue: resta un confronto su _size, che
+     * viene letto comunque per calcolare lo slot. Senza slot nell'oggetto
+     * (inline_capacity == 0) il test sparisce e ritorna _queue come prima.
+     * Come _queue, non propaga const agli elementi.
+     *
+     * @return T* inizio dell'array dei dati
+     */
+    T* data() const noexcept{
+        if constexpr(inline_capacity > 0){
+            if(_size <= inline_capacity) // _size == 0: nessun elemento da leggere
+                return const_cast<T*>(_inline.data());
+        }
+        return _queue;
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna true se i dati sono salvati
+     * nell'oggetto invece che in un array allocato
+     *
+     * @return true se _queue punta agli slot nell'oggetto
+     */
+    bool is_inline() const noexcept{
+        if constexpr(inline_capacity == 0)
+            return false;
+        else
+            return _queue == _inline.data();
+    }
    
+    /**
+     * @brief Funzione di supporto che alloca con l'allocatore memoria non
+     * inizializzata, allineata per T, per n elementi. Nessun elemento viene costruito.
+     * Se n è compreso tra 1 e inline_capacity ritorna gli slot nell'oggetto
+     * (con n == 0 la coda non è mai nell'oggetto, così is_inline() implica
+     * una dimensione positiva).
+     * 
+     * @param n numero di elementi
+     * @return T* puntatore all'area allocata
+     * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita
+     */
+    T* allocate(unsigned int n){
+        if constexpr(inline_capacity > 0){
+            if(n > 0 && n <= inline_capacity)
+                return _inline.data();
+        }
+        return alloc_traits::allocate(_allocator, n);
+    }
+
+    /**
+     * @brief Funzione di supporto che libera la memoria allocata con allocate.
+     * Gli elementi devono essere già stati distrutti.
+     * 
+     * @param p puntatore all'area da liberare
+     * @param n numero di elementi con cui l'area è stata allocata
+     */
+    void deallocate(T *p, unsigned int n){
+        if(p != nullptr && p != _inline.data())
+            alloc_traits::deallocate(_allocator, p, n);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia empty_queue_exception
+     * 
+     * @param message stringa contenente il messaggio
+     * @throw empty_queue_exception sempre
+     */
+    [[noreturn]] CBUFFER_COLD static void throw_empty(const char *message){
+        throw empty_queue_exception(message);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::out_of_range per operator[]
+     * 
+     * @throw std::out_of_range sempre
+     */
+    [[noreturn]] CBUFFER_COLD static void throw_out_of_range(){
+        throw std::out_of_range("Cannot call the operator[] due to an index out of bound");
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::length_error
+     * 
+     * @param message stringa contenente il messaggio
+     * @throw std::length_error sempre
+     */
+    [[noreturn]] CBUFFER_COLD static void throw_length(const char *message){
+        throw std::length_error(message);
+    }
+
+#ifdef CBUFFER_POSIX_IO
+    /**
+     * @brief Funzione di supporto che attende che fd sia pronto per
+     * l'operazione events (per descrittori non bloccanti)
+     *
+     * @param fd descrittore
+     * @param events POLLIN o POLLOUT
+     */
+    static void wait_fd(int fd, short events){
+        struct pollfd p = {fd, events, 0};
+        poll(&p, 1, -1);
+    }
+
+    /**
+     * @brief Funzione di supporto che scrive tutti gli n byte di data su fd,
+     * usata per completare un elemento scritto solo in parte
+     *
+     * @param fd descrittore
+     * @param data byte da scrivere
+     * @param n numero di byte
+     * @throw std::system_error eccezione lanciata in caso di errore di scrittura
+     */
+    static void write_all(int fd, const char *data, std::size_t n){
+        while(n > 0){
+            ssize_t written = write(fd, data, n);
+            if(written < 0){
+                if(errno == EINTR)
+                    continue;
+                if(errno == EAGAIN || errno == EWOULDBLOCK){
+                    wait_fd(fd, POLLOUT);
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Cannot write the cbuffer");
+            }
+            data += written;
+            n -= written;
+        }
+    }
+
+    /**
+     * @brief Funzione di supporto che legge n byte da fd in data, usata
+     * per completare un elemento letto solo in parte
+     *
+     * @param fd descrittore
+     * @param data destinazione
+     * @param n numero di byte
+     * @return true se sono stati letti tutti gli n byte
+     * @return false se il file è finito prima
+     * @throw std::system_error eccezione lanciata in caso di errore di lettura
+     */
+    static bool read_all(int fd, char *data, std::size_t n){
+        while(n > 0){
+            ssize_t r = read(fd, data, n);
+            if(r < 0){
+                if(errno == EINTR)
+                    continue;
+                if(errno == EAGAIN || errno == EWOULDBLOCK){
+                    wait_fd(fd, POLLIN);
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Cannot read the cbuffer");
+            }
+            if(r == 0)
+                return false;
+            data += r;
+            n -= r;
+        }
+        return true;
+    }
+#endif
+
+    /**
+     * @brief Funzione di supporto che ritorna la posizione nell'array
+     * dell'elemento a distanza offset dalla testa
+     * 
+     * @param offset distanza dalla testa
+     * @return unsigned int posizione nell'array
+     */
+    unsigned int slot(unsigned int offset) const{
+        return Index::slot(_head + offset, _size);
+    }
+
+    template<typename C, typename V> friend class cbuffer_iterator; ///< gli iteratori leggono gli slot con at_offset
+
+    /**
+     * @brief Funzione di supporto che ritorna l'elemento a distanza
+     * offset dalla testa, senza controlli (usata dagli iteratori)
+     *
+     * @param offset distanza dalla testa
+     * @return T& riferimento dell'elemento
+     */
+    T& at_offset(unsigned int offset){
+        return data()[slot(offset)];
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna l'elemento a distanza
+     * offset dalla testa, senza controlli (usata dagli iteratori)
+     *
+     * @param offset distanza dalla testa
+     * @return const T& riferimento dell'elemento
+     */
+    const T& at_offset(unsigned int offset) const{
+        return data()[slot(offset)];
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna la posizione nell'array della testa
+     * 
+     * @return int posizione della testa, -1 se la coda è vuota
+     */
+    int head_index() const{
+        return is_empty() ? -1 : static_cast<int>(slot(0));
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna la posizione nell'array della coda
+     * 
+     * @return int posizione della coda, -1 se la coda è vuota
+     */
+    int tail_index() const{
+        return is_empty() ? -1 : static_cast<int>(slot(_stored_elements - 1));
+    }
+
+    /**
+     * @brief Funzione di supporto che distrugge gli elementi salvati
+     * (solo gli slot occupati, da head a tail, un segmento contiguo alla
+     * volta). Non fa nulla se T ha il distruttore banale.
+     */
+    void destroy_elements(){
+        if constexpr(!std::is_trivially_destructible<T>::value){
+            if(_stored_elements == 0)
+                return;
+            unsigned int start = slot(0);
+            unsigned int first = std::min(_stored_elements, _size - start);
+            std::destroy_n(data() + start, first);
+            std::destroy_n(data(), _stored_elements - first);
+        }
+    }
+
+    /**
+     * @brief Funzione di supporto che accoda value copiandolo o
+     * spostandolo a seconda della categoria di U
+     * 
+     * @tparam U tipo del valore (const T& oppure T)
+     * @param value valore da inserire
+     * @return true se l'elemento è stato inserito
+     * @return false se la coda è piena e Overflow è reject_on_full
+     * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+     * (tranne con grow_on_full)
+     */
+    template<typename U> bool push(U &&value){
+        if constexpr (grows){
+            if(_stored_elements == _size){
+                T tmp(std::forward<U>(value)); // value può essere un elemento della coda
+                grow(1);
+                new (data() + slot(_stored_elements)) T(std::move(tmp));
+                _stored_elements++;
+                return true;
+            }
+        }else if(_size <= 0)
+            throw_empty("Cannot add an element in an empty queue");
+
+        if (_stored_elements == _size){ //coda piena: lo slot successivo a tail è quello di head
+            if constexpr (rejects){
+                return false;
+            }else{
+                data()[slot(0)] = std::forward<U>(value); //lo slot è occupato: assegnamento sull'elemento più vecchio
+                _head = Index::advance(_head, 1, _size);
+                return true; //stored elements non varia
+            }
+        }
+        
+        new (data() + slot(_stored_elements)) T(std::forward<U>(value)); //lo slot è libero: costruzione in loco
+        _stored_elements++;
+        return true;
+    }
+
+    /**
+     * @brief Funzione di supporto che distrugge l'elemento in testa
+     * e sposta la testa di una posizione. La coda non deve essere vuota.
+     * 
+     * @post _stored_elements = _stored_elements - 1
+     */
+    void pop_head(){
+        data()[slot(0)].~T(); // lo slot torna libero
+        _stored_elements--;
+        _head = Index::advance(_head, 1, _size); 
+    }
+
+    /**
+     * @brief Funzione di supporto che costruisce n elementi negli slot liberi
+     * a partire dalla distanza offset dalla testa, copiandoli da src.
+     * Gli slot vengono scritti in al più due segmenti contigui
+     * (std::uninitialized_copy si riduce a memmove per T banalmente copiabili).
+     * 
+     * @tparam It tipo dell'iteratore sorgente
+     * @param offset distanza dalla testa del primo slot da scrivere
+     * @param src iteratore sorgente, spostato in avanti di n posizioni
+     * @param n numero di elementi da costruire
+     * @post _stored_elements = _stored_elements + n
+     */
+    template<typename It> void construct_segments(unsigned int offset, It &src, unsigned int n){
+        unsigned int start = slot(offset);
+        unsigned int first = std::min(n, _size - start);
+        It end = std::next(src, first);
+        std::uninitialized_copy(src, end, data() + start);
+        _stored_elements += first;
+        src = end;
+        end = std::next(src, n - first);
+        std::uninitialized_copy(src, end, data());
+        _stored_elements += n - first;
+        src = end;
+    }
+
+    /**
+     * @brief Funzione di supporto che assegna n elementi agli slot occupati
+     * a partire dalla testa, in al più due segmenti contigui
+     * (std::copy si riduce a memmove per T banalmente copiabili)
+     * 
+     * @tparam It tipo dell'iteratore sorgente
+     * @param src iteratore sorgente, spostato in avanti di n posizioni
+     * @param n numero di elementi da assegnare
+     * @post la testa è spostata in avanti di n posizioni
+     */
+    template<typename It> void assign_segments(It &src, unsigned int n){
+        unsigned int start = slot(0);
+        unsigned int first = std::min(n, _size - start);
+        src = assign_n(src, first, data() + start);
+        src = assign_n(src, n - first, data());
+        _head = Index::advance(_head, n, _size);
+    }
+
+    /**
+     * @brief Funzione di supporto che assegna n elementi di src a dst,
+     * convertendoli a T se il tipo sorgente è diverso
+     * 
+     * @tparam It tipo dell'iteratore sorgente (forward)
+     * @param src iteratore sorgente
+     * @param n numero di elementi
+     * @param dst puntatore al primo slot da assegnare
+     * @return It iteratore sorgente spostato di n posizioni
+     */
+    template<typename It> static It assign_n(It src, unsigned int n, T *dst){
+        if constexpr (std::is_same<typename std::iterator_traits<It>::value_type, T>::value){
+            It end = std::next(src, n);
+            std::copy(src, end, dst);
+            return end;
+        }else{
+            for(; n > 0; --n, ++src, ++dst)
+                *dst = static_cast<T>(*src);
+            return src;
+        }
+    }
 
     /**
      * @brief Funzione di supporto per eliminare dalla
      * memoria tutti i dati
      */
     void erase(){
-        delete[] _queue;
+        destroy_elements();
+        deallocate(_queue, _size);
         _queue = nullptr;
-        _head = _tail = -1;
-        _size = _stored_elements = 0;
+        _head = _size = _stored_elements = 0;
+    }
+
+    /**
+     * @brief Funzione di supporto che prende i dati di other, che resta
+     * vuota con dimensione 0. Se other ha un array allocato viene preso
+     * l'array, se ha i dati nell'oggetto gli elementi vengono spostati
+     * negli slot nell'oggetto di this. This non deve avere dati (erase).
+     * 
+     * @param other coda da cui prendere i dati (con un allocatore uguale a quello di this)
+     */
+    void adopt(cbuffer &other){
+        if(!other.is_inline()){
+            _head = other._head;
+            _size = other._size;
+            _stored_elements = other._stored_elements;
+            _queue = other._queue;
+            other._queue = nullptr;
+            other._head = other._size = other._stored_elements = 0;
+            return;
+        }
+        _size = other._size;
+        _queue = _inline.data();
+        array_range one = other.array_one(), two = other.array_two();
+        std::move_iterator<T*> src(one.first);
+        construct_segments(_stored_elements, src, one.second);
+        src = std::move_iterator<T*>(two.first);
+        construct_segments(_stored_elements, src, two.second);
+        other.erase();
+    }
+
+    /**
+     * @brief Funzione di supporto che copia o sposta gli elementi di
+     * [first, last) negli slot non inizializzati a partire da dst. Gli
+     * elementi vengono spostati se lo spostamento non lancia eccezioni
+     * (o se T non è copiabile), come fa std::vector quando rialloca.
+     * 
+     * @param first inizio del segmento
+     * @param last fine del segmento
+     * @param dst primo slot di destinazione
+     * @return T* slot successivo all'ultimo costruito
+     */
+    static T* relocate_segment(T *first, T *last, T *dst){
+        if constexpr (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value)
+            return std::uninitialized_move(first, last, dst);
+        else
+            return std::uninitialized_copy(first, last, dst);
+    }
+
+    /**
+     * @brief Funzione di supporto che porta la capacità a capacity (già
+     * arrotondata da Index::capacity): i due segmenti vengono spostati in
+     * ordine all'inizio di un nuovo array (memmove per T banalmente
+     * copiabili) e la testa torna a 0. Se gli elementi salvati sono più di
+     * capacity vengono spostati solo i più recenti e gli altri distrutti
+     * dopo l'allocazione. Se i dati sono nell'oggetto e ci restano, vengono
+     * spostati all'inizio degli slot nell'oggetto.
+     * 
+     * @param capacity nuova capacità
+     * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita (la coda non cambia)
+     */
+    void relocate(unsigned int capacity){
+        unsigned int skip = _stored_elements > capacity ? _stored_elements - capacity : 0; // restano i più recenti
+        if(is_inline() && capacity > 0 && capacity <= inline_capacity){
+            for(; skip > 0; --skip) // nessuna allocazione da attendere
+                pop_head();
+            // linearize non sposta i dati già contigui: li porto all'inizio degli slot
+            unsigned int start = is_empty() ? 0 : linearize().first - _queue;
+            for(unsigned int i = 0; i < _stored_elements && start != 0; ++i){
+                new (_queue + i) T(std::move(_queue[start + i])); // lo slot i è libero o già spostato
+                _queue[start + i].~T();
+            }
+            _head = 0;
+            _size = capacity;
+            return;
+        }
+        T *queue = allocate(capacity);
+        array_range one = array_one(), two = array_two();
+        unsigned int skip_one = std::min(skip, one.second);
+        one.first += skip_one;
+        one.second -= skip_one;
+        two.first += skip - skip_one;
+        two.second -= skip - skip_one;
+        T *dst = queue;
+        try{
+            dst = relocate_segment(one.first, one.first + one.second, queue);
+            try{
+                relocate_segment(two.first, two.first + two.second, dst);
+            }catch(...){
+                std::destroy(queue, dst);
+                throw;
+            }
+        }catch(...){
+            deallocate(queue, capacity);
+            throw;
+        }
+        unsigned int n = _stored_elements - skip;
+        destroy_elements();
+        deallocate(_queue, _size);
+        _queue = queue;
+        _size = capacity;
+        _head = 0;
+        _stored_elements = n;
+    }
+
+    /**
+     * @brief Funzione di supporto che aumenta la capacità in modo che
+     * entrino altri extra elementi: almeno il doppio della capacità
+     * attuale, così n inserimenti costano O(n) spostamenti in totale.
+     * Il doppio viene limitato al massimo unsigned int invece di tornare a 0.
+     * 
+     * @param extra numero di elementi da aggiungere
+     * @throw std::length_error eccezione lanciata se la capacità necessaria non è rappresentabile
+     */
+    void grow(unsigned int extra){
+        constexpr unsigned int max = std::numeric_limits<unsigned int>::max();
+        if(extra > max - _stored_elements)
+            throw_length("Cannot grow the queue beyond the largest capacity");
+        unsigned int doubled = _size > max / 2 ? max : _size * 2;
+        relocate(Index::capacity(std::max(doubled, _stored_elements + extra)));
     }
 
     public:
+        typedef typename alloc_traits::allocator_type allocator_type; ///< tipo dell'allocatore dell'array
+
         /**
          * @brief Costruttore di dafault
          * 
-         * @post _head == -1
-         * @post _tail == -1
+         * @post _head == 0
          * @post _size == 0
          * @post _stored_elements == 0
          * @post _queue == nullptr
          * 
          */
-        cbuffer(): _head(-1), _tail(-1), _size(0), _stored_elements(0), _queue(nullptr){}
+        cbuffer(): _head(0), _size(0), _stored_elements(0), _queue(nullptr), _allocator(){}
+
+        /**
+         * @brief Costruttore di una coda vuota di dimensione 0 che userà
+         * l'allocatore alloc
+         * 
+         * @param alloc allocatore dell'array
+         * @post _queue == nullptr
+         */
+        explicit cbuffer(const allocator_type &alloc): _head(0), _size(0), _stored_elements(0), _queue(nullptr), _allocator(alloc){}
+
+        /**
+         * @brief Costruttore secondario
+         * 
+         * @param size dimensione massima della coda (arrotondata da Index::capacity)
+         * @param alloc allocatore dell'array
+         * @post _head == 0
+         * @post _size == Index::capacity(size)
+         * @post _stored_elements == 0
+         * @post _queue != nullptr
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione dell'array non riuscita
+         */
+        explicit cbuffer(int size, const allocator_type &alloc = allocator_type())
+            :_head(0), _size(0), _stored_elements(0), _queue(nullptr), _allocator(alloc){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a cbuffer with a negative size");
+            try{
+                _size = Index::capacity(size);
+                _queue = allocate(_size);
+            }catch(...){
+                erase();
+                throw;
+            }
+        }
+        
+        /**
+         * @brief Copy constructor
+         * 
+         * @param other coda da copiare
+         * 
+         * @post stored_elements() == other.stored_elements()
+         * @post _size == other._size
+         * @post _stored_elements == other._stored_elements
+         * @post _queue != nullptr
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione dell'array non riuscita
+         */
+        cbuffer(const cbuffer &other)
+            : cbuffer(other, alloc_traits::select_on_container_copy_construction(other._allocator)){}
+
+        /**
+         * @brief Copy constructor con allocatore
+         * 
+         * @param other coda da copiare
+         * @param alloc allocatore dell'array della copia
+         * 
+         * @post stored_elements() == other.stored_elements()
+         * @post _size == other._size
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione dell'array non riuscita
+         */
+        cbuffer(const cbuffer &other, const allocator_type &alloc)
+            :_head(0), _size(0), _stored_elements(0), _queue(nullptr), _allocator(alloc){
+            try{
+                _size = other._size;
+                _queue = allocate(other._size);
+                const_array_range one = other.array_one();
+                const_array_range two = other.array_two();
+                enqueue_range(one.first, one.first + one.second);
+                enqueue_range(two.first, two.first + two.second);
+            }catch(...){
+                erase();
+                throw;
+            }
+        }
+
+        /**
+         * @brief Costruttore templato sul tipo Q
+         * 
+         * @tparam Q tipo dell'iteratore passato in input
+         * @param size dimensione con cui costruire la coda
+         * @param b iteratore di inizio
+         * @param e iteratore di fine
+         * @param alloc allocatore dell'array
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimenzione negativa (< 0)
+         * @throw empty_queue_exception eccezione lanciata in caso di dimenzione nulla
+         */
+        template<typename Q> cbuffer(int size, Q b, Q e, const allocator_type &alloc = allocator_type())
+            : _head(0), _size(0), _stored_elements(0), _queue(nullptr), _allocator(alloc){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a cbuffer with a negative size");
+            if(size == 0)
+                throw empty_queue_exception("Cannot create a cbuffer from the iterators due to: size = 0");
+            try{
+                _size = Index::capacity(size);
+                _queue = allocate(_size);
+                enqueue_range(b, e);
+
+            }catch(...){
+                erase();
+                throw;
+            }   
+        }
+
+        /**
+         * @brief Operatore assegnamento
+         * 
+         * @param other coda da copiare
+         * @return cbuffer& riferimento al cbuffer this
+         * 
+         * @post stored_elements() == other.stored_elements()
+         * @post _size == other._size
+         * @post _stored_elements == other._stored_elements
+         * @post _queue != nullptr
+         */
+        cbuffer& operator=(const cbuffer &other){
+            if(this != &other){
+                // la copia usa l'allocatore che this avrà dopo l'assegnamento
+                cbuffer tmp(other, alloc_traits::propagate_on_container_copy_assignment::value ? other._allocator : _allocator);
+                erase();
+                if constexpr(alloc_traits::propagate_on_container_copy_assignment::value)
+                    std::swap(_allocator, tmp._allocator);
+                adopt(tmp);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Move constructor. L'array di other viene preso senza
+         * copie; se other ha i dati nell'oggetto (small_buffer_allocator)
+         * gli elementi vengono spostati uno a uno.
+         * 
+         * @param other coda da cui spostare i dati
+         * 
+         * @post other.size() == 0
+         * @post other.stored_elements() == 0
+         */
+        cbuffer(cbuffer &&other) noexcept(inline_capacity == 0 || std::is_nothrow_move_constructible<T>::value)
+            : _head(0), _size(0), _stored_elements(0), _queue(nullptr), _allocator(std::move(other._allocator)){
+            adopt(other);
+        }
+
+        /**
+         * @brief Operatore assegnamento di spostamento. Se l'allocatore non
+         * si propaga e quello di other è diverso da quello di this, gli
+         * elementi vengono spostati uno a uno in un array allocato da this.
+         * 
+         * @param other coda da cui spostare i dati
+         * @return cbuffer& riferimento al cbuffer this
+         * 
+         * @post other.size() == 0
+         * @post other.stored_elements() == 0
+         * @throw std::bad_alloc eccezione lanciata se serve un nuovo array e l'allocazione non riesce
+         */
+        cbuffer& operator=(cbuffer &&other) noexcept((alloc_traits::propagate_on_container_move_assignment::value
+            || alloc_traits::is_always_equal::value) && (inline_capacity == 0 || std::is_nothrow_move_constructible<T>::value)) {
+            if(this == &other)
+                return *this;
+            if(alloc_traits::propagate_on_container_move_assignment::value || _allocator == other._allocator){
+                erase();
+                if constexpr(alloc_traits::propagate_on_container_move_assignment::value)
+                    std::swap(_allocator, other._allocator);
+                adopt(other);
+            }else{
+                cbuffer tmp(other._size, _allocator);
+                array_range one = other.array_one();
+                array_range two = other.array_two();
+                tmp.enqueue_range(std::make_move_iterator(one.first), std::make_move_iterator(one.first + one.second));
+                tmp.enqueue_range(std::make_move_iterator(two.first), std::make_move_iterator(two.first + two.second));
+                other.erase();
+                erase();
+                adopt(tmp);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Funzione che ritorna una copia dell'allocatore dell'array
+         * 
+         * @return allocator_type allocatore della coda
+         */
+        allocator_type get_allocator() const{
+            return _allocator;
+        }
+
+        /**
+         * @brief Distruttore
+         * 
+         */
+        ~cbuffer(){
+            erase();
+        }
+
+        /**
+         * @brief Funzione che distrugge gli elementi salvati, imposta il
+         * contatore della testa e il numero di elementi salvati a 0.
+         * La memoria della coda non viene liberata né riallocata: il costo
+         * è proporzionale agli elementi salvati, costante se T ha il
+         * distruttore banale.
+         * 
+         * @post _head == 0
+         * @post _stored_elements == 0
+         */
+        void clear(){
+            destroy_elements();
+            _head = 0;
+            _stored_elements = 0;
+        }
+
+        /**
+         * @brief Funzione che porta la capacità ad almeno n elementi
+         * (arrotondata da Index::capacity). Se serve, gli elementi vengono
+         * spostati in ordine in un nuovo array; se la capacità è già
+         * sufficiente non succede nulla. Invalida iteratori e riferimenti
+         * se l'array cambia.
+         * 
+         * @param n capacità minima
+         * @post size() >= n
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita (la coda non cambia)
+         * @throw std::length_error eccezione lanciata se Index non può rappresentare la capacità (pow2_index oltre 2^31)
+         */
+        void reserve(unsigned int n){
+            if(n > _size)
+                relocate(Index::capacity(n));
+        }
+
+        /**
+         * @brief Funzione che porta la capacità a n elementi (arrotondata
+         * da Index::capacity), anche riducendola. Se gli elementi salvati
+         * sono più della nuova capacità, restano i più recenti (come quando
+         * la coda piena viene sovrascritta). Gli elementi vengono spostati
+         * in ordine in un nuovo array.
+         * 
+         * @param n nuova capacità
+         * @post size() == Index::capacity(n)
+         * @post stored_elements() == min(stored_elements(), size())
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita (la coda non cambia)
+         * @throw std::length_error eccezione lanciata se Index non può rappresentare la capacità (pow2_index oltre 2^31)
+         */
+        void resize_capacity(unsigned int n){
+            unsigned int capacity = Index::capacity(n);
+            if(capacity == _size)
+                return;
+            relocate(capacity);
+        }
+
+
+        /**
+         * @brief Funzione che accoda il valore passato in input secondo
+         * la logica FIFO. Se la coda è piena l'elemento più vecchio viene
+         * sovrascritto (overwrite_on_full) oppure l'inserimento viene
+         * rifiutato (reject_on_full).
+         * 
+         * @param value valore da inserire in test
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full
+         * 
+         * @post _stored_elements = _stored_elements + 1
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+         */
+        bool enqueue(const T& value){
+            return push(value);
+        }
+
+        /**
+         * @brief Funzione che accoda il valore passato in input secondo
+         * la logica FIFO, spostandolo nella coda
+         * 
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full (value non viene spostato)
+         * 
+         * @post _stored_elements = _stored_elements + 1
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+         */
+        bool enqueue(T&& value){
+            return push(std::move(value));
+        }
+
+        /**
+         * @brief Funzione che costruisce in coda un nuovo elemento a partire
+         * dagli argomenti passati in input, senza copie né spostamenti.
+         * Se la coda è piena l'elemento più vecchio viene distrutto
+         * e sostituito, quindi gli argomenti non devono riferirsi
+         * ad elementi della coda (con grow_on_full la capacità aumenta).
+         * 
+         * Disponibile solo con overwrite_on_full (con reject_on_full usare try_emplace).
+         * 
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return T& riferimento all'elemento costruito
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+         */
+        template<typename... Args> T& emplace(Args&&... args){
+            static_assert(!rejects, "emplace cannot report a rejected insertion: use try_emplace");
+            if constexpr (grows){
+                if(_stored_elements == _size){
+                    T value(std::forward<Args>(args)...); // gli argomenti possono riferirsi a elementi della coda
+                    grow(1);
+                    T *p = new (data() + slot(_stored_elements)) T(std::move(value));
+                    _stored_elements++;
+                    return *p;
+                }
+            }else{
+                if(_size <= 0)
+                    throw_empty("Cannot add an element in an empty queue");
+
+                if(is_full()) //libero lo slot dell'elemento più vecchio
+                    pop_head();
+            }
+
+            T *p = new (data() + slot(_stored_elements)) T(std::forward<Args>(args)...);
+            _stored_elements++;
+            return *p;
+        }
+
+        /**
+         * @brief Funzione che costruisce in coda un nuovo elemento a partire
+         * dagli argomenti passati in input, senza lanciare empty_queue_exception.
+         * Se la coda è piena si comporta secondo Overflow.
+         * 
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        template<typename... Args> bool try_emplace(Args&&... args){
+            if constexpr (grows){
+                emplace(std::forward<Args>(args)...);
+                return true;
+            }
+            if(_size == 0)
+                return false;
+            if(is_full()){
+                if constexpr (rejects)
+                    return false;
+                else
+                    pop_head(); //libero lo slot dell'elemento più vecchio
+            }
+            new (data() + slot(_stored_elements)) T(std::forward<Args>(args)...);
+            _stored_elements++;
+            return true;
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa spostandolo
+         * nel valore di ritorno
+         * 
+         * @return T elemento rimosso
+         * @post _stored_elements = _stored_elements - 1
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione di un elemento da una coda vuota
+         */
+        T pop(){
+            if(is_empty())
+                throw_empty("Cannot remove an element from an empty queue");
+            
+            T value(std::move(data()[slot(0)])); // elemento in testa
+            pop_head();
+            return value; 
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa
+         * 
+         * @return T elemento rimosso (equivalente a pop())
+         * @post _stored_elements = _stored_elements - 1
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione di un elemento da una coda vuota
+         */
+        T dequeue(){
+            return pop();
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in coda (l'ultimo inserito)
+         * spostandolo nel valore di ritorno. Insieme a enqueue e pop
+         * permette di usare il cbuffer come deque a capacità fissa.
+         *
+         * @return T elemento rimosso
+         * @post _stored_elements = _stored_elements - 1
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione di un elemento da una coda vuota
+         */
+        T pop_tail(){
+            if(is_empty())
+                throw_empty("Cannot remove an element from an empty queue");
+
+            T *p = data() + slot(_stored_elements - 1);
+            T value(std::move(*p));
+            p->~T(); // lo slot torna libero, la testa non si sposta
+            _stored_elements--;
+            return value;
+        }
+
+        /**
+         * @brief Funzione che accoda una copia di value senza lanciare
+         * empty_queue_exception
+         * 
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        bool try_enqueue(const T& value){
+            if(!grows && _size == 0)
+                return false;
+            return push(value);
+        }
+
+        /**
+         * @brief Funzione che accoda value spostandolo, senza lanciare
+         * empty_queue_exception
+         * 
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         * (value non viene spostato)
+         */
+        bool try_enqueue(T&& value){
+            if(!grows && _size == 0)
+                return false;
+            return push(std::move(value));
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa spostandolo in value,
+         * senza lanciare eccezioni se la coda è vuota
+         * 
+         * @param value riferimento in cui spostare l'elemento rimosso
+         * @return true se un elemento è stato rimosso
+         * @return false se la coda è vuota (value non viene modificato)
+         */
+        bool try_dequeue(T& value) noexcept(std::is_nothrow_move_assignable<T>::value){
+            if(is_empty())
+                return false;
+            value = std::move(data()[slot(0)]);
+            pop_head();
+            return true;
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa spostandolo
+         * nel valore di ritorno, senza lanciare eccezioni se la coda è vuota
+         * 
+         * @return std::optional<T> elemento rimosso, vuoto se la coda è vuota
+         */
+        std::optional<T> try_pop() noexcept(std::is_nothrow_move_constructible<T>::value){
+            if(is_empty())
+                return std::nullopt;
+            std::optional<T> value(std::move(data()[slot(0)]));
+            pop_head();
+            return value;
+        }
+
+#ifdef CBUFFER_POSIX_IO
+        /**
+         * @brief Funzione che scrive gli elementi della coda sul descrittore fd
+         * e li rimuove, con una writev sui (al più due) segmenti contigui
+         * invece di un'operazione per elemento. Dopo una scrittura parziale
+         * la testa avanza degli elementi scritti e la writev viene ripetuta
+         * sul resto; un elemento scritto solo in parte viene completato,
+         * quindi sul descrittore finiscono sempre elementi interi.
+         *
+         * Con un descrittore non bloccante la funzione termina quando la
+         * scrittura restituirebbe EAGAIN, lasciando in coda il resto.
+         *
+         * @return unsigned int numero di elementi scritti e rimossi
+         * @throw std::system_error eccezione lanciata in caso di errore di scrittura
+         */
+        unsigned int write_to_fd(int fd){
+            static_assert(std::is_trivially_copyable<T>::value, "write_to_fd requires a trivially copyable type");
+            unsigned int written = 0;
+            while(!is_empty()){
+                array_range one = array_one(), two = array_two();
+                struct iovec iov[2] = {{one.first, one.second * sizeof(T)}, {two.first, two.second * sizeof(T)}};
+                ssize_t n = writev(fd, iov, two.second > 0 ? 2 : 1);
+                if(n < 0){
+                    if(errno == EINTR)
+                        continue;
+                    if(errno == EAGAIN || errno == EWOULDBLOCK)
+                        break;
+                    throw std::system_error(errno, std::generic_category(), "Cannot write the cbuffer");
+                }
+                if(n == 0)
+                    break;
+                unsigned int done = static_cast<unsigned int>(n / sizeof(T));
+                std::size_t partial = n % sizeof(T);
+                if(partial != 0){
+                    write_all(fd, reinterpret_cast<const char*>(data() + slot(done)) + partial, sizeof(T) - partial);
+                    ++done;
+                }
+                _head = Index::advance(_head, done, _size); // T banalmente distruttibile
+                _stored_elements -= done;
+                written += done;
+            }
+            return written;
+        }
+
+        /**
+         * @brief Funzione che legge dal descrittore fd fino a n elementi e li
+         * accoda, con una readv sugli slot liberi (al più due segmenti
+         * contigui). Vengono letti al più size() - stored_elements() elementi:
+         * la lettura non sovrascrive mai gli elementi presenti. Un elemento
+         * letto solo in parte viene completato con altre letture; se il file
+         * finisce prima, l'elemento incompleto viene scartato.
+         *
+         * @param fd descrittore
+         * @param n numero massimo di elementi da leggere
+         * @return unsigned int numero di elementi letti (0 a fine file, con la
+         * coda piena o se un descrittore non bloccante non ha dati)
+         * @throw std::system_error eccezione lanciata in caso di errore di lettura
+         */
+        unsigned int read_from_fd(int fd, unsigned int n){
+            static_assert(std::is_trivially_copyable<T>::value, "read_from_fd requires a trivially copyable type");
+            n = std::min(n, _size - _stored_elements);
+            if(n == 0)
+                return 0;
+            unsigned int start = slot(_stored_elements);
+            unsigned int first = std::min(n, _size - start);
+            struct iovec iov[2] = {{data() + start, first * sizeof(T)}, {data(), (n - first) * sizeof(T)}};
+            ssize_t r;
+            do{
+                r = readv(fd, iov, n > first ? 2 : 1);
+            }while(r < 0 && errno == EINTR);
+            if(r < 0){
+                if(errno == EAGAIN || errno == EWOULDBLOCK)
+                    return 0;
+                throw std::system_error(errno, std::generic_category(), "Cannot read the cbuffer");
+            }
+            unsigned int done = static_cast<unsigned int>(r / sizeof(T));
+            std::size_t partial = r % sizeof(T);
+            if(partial != 0 && read_all(fd, reinterpret_cast<char*>(data() + slot(_stored_elements + done)) + partial, sizeof(T) - partial))
+                ++done;
+            _stored_elements += done;
+            return done;
+        }
+#endif
+
+        /**
+         * @brief Funzione che ritorna la testa della coda senza lanciare eccezioni
+         * 
+         * @return T* puntatore alla testa, nullptr se la coda è vuota
+         */
+        T* try_front() noexcept{
+            return is_empty() ? nullptr : data() + slot(0);
+        }
+
+        /**
+         * @brief Funzione che ritorna la testa della coda senza lanciare eccezioni
+         * 
+         * @return const T* puntatore alla testa, nullptr se la coda è vuota
+         */
+        const T* try_front() const noexcept{
+            return is_empty() ? nullptr : data() + slot(0);
+        }
 
         /**
-         * @brief Costruttore secondario
+         * @brief Funzione che ritorna la coda della coda senza lanciare eccezioni
          * 
-         * @param size dimensione massima della coda
-         * @post _head == -1
-         * @post _tail == -1
-         * @post _size == size
-         * @post _stored_elements == 0
-         * @post _queue != nullptr
-         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
-         * @throw std::bad_alloc eccezione lanciata in caso di allocazione dell'array non riuscita
+         * @return T* puntatore alla coda, nullptr se la coda è vuota
          */
-        explicit cbuffer(int size):_head(-1), _tail(-1), _size(0), _stored_elements(0), _queue(nullptr){
-            if(size < 0)
-                throw negative_queue_size_exception("Cannot create a cbuffer with a negative size");
-            try{
-                _size = size;
-                _queue = new T[_size];
-            }catch(...){
-                erase();
-                throw;
-            }
+        T* try_back() noexcept{
+            return is_empty() ? nullptr : data() + slot(_stored_elements - 1);
         }
-        
+
         /**
-         * @brief Copy constructor
+         * @brief Funzione che ritorna la coda della coda senza lanciare eccezioni
          * 
-         * @param other coda da copiare
+         * @return const T* puntatore alla coda, nullptr se la coda è vuota
+         */
+        const T* try_back() const noexcept{
+            return is_empty() ? nullptr : data() + slot(_stored_elements - 1);
+        }
+
+        /**
+         * @brief Funzione che accoda gli elementi della sequenza [first, last)
+         * secondo la logica FIFO. Se la sequenza non entra nello spazio libero,
+         * con overwrite_on_full vengono sovrascritti gli elementi più vecchi
+         * (se è più lunga della capacità restano solo gli ultimi size() elementi),
+         * con reject_on_full vengono inseriti solo i primi elementi che entrano,
+         * con grow_on_full la capacità aumenta (la sequenza non deve
+         * riferirsi a elementi della coda).
+         * Per iteratori forward la scrittura avviene in al più due segmenti
+         * contigui di copie in blocco, per iteratori di input elemento per elemento.
          * 
-         * @post _head == other._head
-         * @post _tail == other._tail
-         * @post _size == other._size
-         * @post _stored_elements == other._stored_elements
-         * @post _queue != nullptr
-         * @throw std::bad_alloc eccezione lanciata in caso di allocazione dell'array non riuscita
+         * @tparam It tipo dell'iteratore (il valore deve essere convertibile a T)
+         * @param first iteratore di inizio
+         * @param last iteratore di fine
+         * @return unsigned int numero di elementi della sequenza accodati
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
          */
-        cbuffer(const cbuffer &other):_head(-1), _tail(-1), _size(0), _stored_elements(0), _queue(nullptr){
-            try{
-                _size = other._size;
-                _queue = new T[other._size];
-                int head = other._head;
-                int tail = other._tail;
-                if(!other.is_empty()){
-                    if(head <= tail){//coda lineare
-                        while(head <= tail){
-                            enqueue(other._queue[head]);
-                            head++;
-                        }
-                    }else { //coda circolare
-                        while (head < other._size ) { // seconda metà
-                            enqueue(other._queue[head]);
-                            head++;
-                        }
-                        head = 0;
-                        while (head <= tail) { //prima metà
-                            enqueue(other._queue[head]);
-                            head++;
-                        }
+        template<typename It> unsigned int enqueue_range(It first, It last){
+            typedef typename std::iterator_traits<It>::iterator_category category;
+            if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value){
+                unsigned int n = static_cast<unsigned int>(std::distance(first, last));
+                if(n == 0)
+                    return 0;
+                if constexpr (grows){
+                    if(n > _size - _stored_elements)
+                        grow(n);
+                    construct_segments(_stored_elements, first, n);
+                    return n;
+                }
+                if(_size <= 0)
+                    throw_empty("Cannot add an element in an empty queue");
+                if constexpr (rejects){
+                    unsigned int free = std::min(n, _size - _stored_elements);
+                    construct_segments(_stored_elements, first, free);
+                    return free;
+                }else{
+                    unsigned int accepted = n;
+                    if(n > _size){ // restano solo gli ultimi _size elementi
+                        std::advance(first, n - _size);
+                        n = _size;
                     }
+                    unsigned int free = std::min(n, _size - _stored_elements);
+                    construct_segments(_stored_elements, first, free);
+                    assign_segments(first, n - free); // coda piena: sovrascrivo i più vecchi
+                    return accepted;
                 }
-            }catch(...){
-                erase();
-                throw;
+            }else{
+                unsigned int accepted = 0;
+                for(; first != last && push(static_cast<T>(*first)); ++first)
+                    accepted++;
+                return accepted;
             }
         }
 
         /**
-         * @brief Costruttore templato sul tipo Q
+         * @brief Funzione che rimuove fino a n elementi dalla testa spostandoli
+         * nella sequenza che inizia da out. La lettura avviene in al più due
+         * segmenti contigui (std::move si riduce a memmove per T banalmente copiabili).
          * 
-         * @tparam Q tipo dell'iteratore passato in input
-         * @param size dimensione con cui costruire la coda
-         * @param b iteratore di inizio
-         * @param e iteratore di fine
-         * @throw negative_queue_size_exception eccezione lanciata in caso di dimenzione negativa (< 0)
-         * @throw empty_queue_exception eccezione lanciata in caso di dimenzione nulla
+         * @tparam OutputIt tipo dell'iteratore di output
+         * @param out iteratore di inizio della sequenza di output
+         * @param n numero massimo di elementi da rimuovere
+         * @return unsigned int numero di elementi effettivamente rimossi (0 se la coda è vuota)
+         * @post _stored_elements = _stored_elements - min(n, _stored_elements)
          */
-        template<typename Q> cbuffer(int size, Q b, Q e): _head(-1), _tail(-1), _size(0), _stored_elements(0), _queue(nullptr){
-            if(size < 0)
-                throw negative_queue_size_exception("Cannot create a cbuffer with a negative size");
-            if(size == 0)
-                throw empty_queue_exception("Cannot create a cbuffer from the iterators due to: size = 0");
-            try{
-                _size = size;
-                _queue = new T[_size];
-                for(; b != e; ++b)
-                    enqueue(static_cast<T>(*b));
-
-            }catch(...){
-                erase();
-                throw;
-            }   
+        template<typename OutputIt> unsigned int dequeue_into(OutputIt out, unsigned int n){
+            n = std::min(n, _stored_elements);
+            if(n == 0)
+                return 0;
+            unsigned int start = slot(0);
+            unsigned int first = std::min(n, _size - start);
+            out = std::move(data() + start, data() + start + first, out);
+            std::move(data(), data() + (n - first), out);
+            std::destroy_n(data() + start, first);
+            std::destroy_n(data(), n - first);
+            _head = Index::advance(_head, n, _size);
+            _stored_elements -= n;
+            return n;
         }
 
+        typedef std::pair<T*, unsigned int> array_range; ///< segmento contiguo (puntatore, lunghezza)
+        typedef std::pair<const T*, unsigned int> const_array_range; ///< segmento contiguo costante (puntatore, lunghezza)
+
         /**
-         * @brief Operatore assegnamento
-         * 
-         * @param other coda da copiare
-         * @return cbuffer& riferimento al cbuffer this
+         * @brief Funzione che ritorna il primo segmento contiguo dei dati:
+         * dalla testa fino alla fine dell'array (o fino alla coda se la
+         * coda non è circolare)
          * 
-         * @post _head == other._head
-         * @post _tail == other._tail
-         * @post _size == other._size
-         * @post _stored_elements == other._stored_elements
-         * @post _queue != nullptr
+         * @return array_range puntatore alla testa e numero di elementi del segmento
          */
-        cbuffer& operator=(const cbuffer &other){
-            if(this != &other){
-                cbuffer tmp(other);
-                std::swap(_head, tmp._head);
-                std::swap(_tail, tmp._tail);
-                std::swap(_size, tmp._size);
-                std::swap(_stored_elements, tmp._stored_elements);
-                std::swap(_queue, tmp._queue);
-            }
-            return *this;
+        array_range array_one(){
+            if(is_empty())
+                return array_range(data(), 0);
+            unsigned int start = slot(0);
+            return array_range(data() + start, std::min(_stored_elements, _size - start));
         }
 
         /**
-         * @brief Distruttore
+         * @brief Funzione che ritorna il primo segmento contiguo dei dati
          * 
+         * @return const_array_range puntatore alla testa e numero di elementi del segmento
          */
-        ~cbuffer(){
-            erase();
+        const_array_range array_one() const{
+            if(is_empty())
+                return const_array_range(data(), 0);
+            unsigned int start = slot(0);
+            return const_array_range(data() + start, std::min(_stored_elements, _size - start));
         }
 
         /**
-         * @brief Funzione che imposta gli indici di testa e coda a -1
-         * e il numero di elementi salvati a 0
+         * @brief Funzione che ritorna il secondo segmento contiguo dei dati:
+         * dall'inizio dell'array fino alla coda. Il segmento è vuoto
+         * se la coda non è circolare.
          * 
-         * @post _head == -1
-         * @post _tail == -1
-         * @post _stored_elements == 0
+         * @return array_range puntatore all'inizio dell'array e numero di elementi del segmento
          */
-        void clear(){
-            delete[] _queue;
-            _queue = new T[_size];
-            _head = _tail = -1;
-            _stored_elements = 0;
+        array_range array_two(){
+            return array_range(data(), _stored_elements - array_one().second);
         }
 
-
         /**
-         * @brief Funzione che accoda il valore passato in input secondo
-         * la logica FIFO
-         * 
-         * @param value valore da inserire in test
+         * @brief Funzione che ritorna il secondo segmento contiguo dei dati
          * 
-         * @post _stored_elements = _stored_elements + 1
-         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+         * @return const_array_range puntatore all'inizio dell'array e numero di elementi del segmento
          */
-        void enqueue(const T& value){
-            if(_size <= 0)
-                throw empty_queue_exception("Cannot add an element in an empty queue");
+        const_array_range array_two() const{
+            return const_array_range(data(), _stored_elements - array_one().second);
+        }
 
-            if ((_tail + 1) % _size == _head){ //coda piena: tail si trova indietro di una posizione (mod) a head
-                _tail = (_tail + 1) % _size; //sposto la coda di una posizione 
-                _queue[_tail] = value; //_queue non sarà mai nullptr
-                _head = (_head + 1) % _size;
-                return; //stored elements non varia
-            }
-            if (_head == -1 && _tail == -1) // inserimento primo elemento
-                _head = _tail = 0;
-            else 
-                _tail = (_tail + 1) % _size; //se la coda contiene dei dati (non piena) sposto tail
-            
-            _queue[_tail] = value;
-            _stored_elements++;
+        /**
+         * @brief Funzione che chiama f su ogni segmento contiguo non vuoto
+         * dei dati, in ordine FIFO (al più due chiamate). Dentro f il
+         * segmento è un normale intervallo di puntatori, quindi gli
+         * algoritmi della STL possono essere vettorizzati dal compilatore.
+         *
+         * @tparam F tipo della funzione, invocabile come f(T *first, T *last)
+         * @param f funzione da applicare ai segmenti
+         * @return F la funzione f dopo le chiamate
+         */
+        template<typename F> F for_each_segment(F f){
+            array_range one = array_one(), two = array_two();
+            if(one.second > 0)
+                f(one.first, one.first + one.second);
+            if(two.second > 0)
+                f(two.first, two.first + two.second);
+            return f;
         }
 
         /**
-         * @brief Funzione che rimuove l'elemento in testa
-         * 
-         * @return T& riferimento dell'elemento rimosso
-         * @post _stored_elements = _stored_elements - 1
-         * @throw empty_queue_exception eccezione lanciata in caso di rimozione di un elemento da una coda vuota
+         * @brief Funzione che chiama f su ogni segmento contiguo non vuoto
+         * dei dati, in ordine FIFO (al più due chiamate)
+         *
+         * @tparam F tipo della funzione, invocabile come f(const T *first, const T *last)
+         * @param f funzione da applicare ai segmenti
+         * @return F la funzione f dopo le chiamate
          */
-        T& dequeue(){
-            if(is_empty())
-                throw empty_queue_exception("Cannot remove an element from an empty queue");
-            
-            T* value = &_queue[_head]; // elemento in testa
-            _stored_elements--;
-            if(_head == _tail)// caso: rimozione dell'ultimo elemento 
-                _head = _tail = -1;
-            else
-                _head = (_head + 1) % _size; 
+        template<typename F> F for_each_segment(F f) const{
+            const_array_range one = array_one(), two = array_two();
+            if(one.second > 0)
+                f(one.first, one.first + one.second);
+            if(two.second > 0)
+                f(two.first, two.first + two.second);
+            return f;
+        }
 
-            return *value; 
+        /**
+         * @brief Funzione che ruota in loco i dati in modo che la testa si trovi
+         * all'inizio dell'array e tutti gli elementi siano in un unico segmento
+         * contiguo. Se i dati sono già contigui non viene spostato nulla.
+         * 
+         * @return array_range puntatore alla testa e numero di elementi salvati
+         * @post array_two().second == 0
+         */
+        array_range linearize(){
+            array_range one = array_one();
+            unsigned int second = _stored_elements - one.second;
+            if(second == 0)
+                return one;
+
+            //sposto il primo segmento subito dopo il secondo, occupando gli slot liberi
+            T *dst = data() + second;
+            if(dst != one.first){
+                for(unsigned int i = 0; i < one.second; ++i){
+                    new (dst + i) T(std::move(one.first[i]));
+                    one.first[i].~T();
+                }
+            }
+            //[secondo segmento | primo segmento] -> [primo segmento | secondo segmento]
+            std::rotate(data(), dst, data() + _stored_elements);
+            _head = 0;
+            return array_range(data(), _stored_elements);
         }
 
         /**
@@ -247,8 +1642,8 @@ template<typename T> class cbuffer{
          */
         T& head() const{ // la testa può essere modificata
             if(is_empty())
-                throw empty_queue_exception("Cannot get the head from an empty queue");
-            return _queue[_head];
+                throw_empty("Cannot get the head from an empty queue");
+            return data()[slot(0)];
         }
         /**
          * @brief Funzione che ritorna la coda della coda
@@ -258,8 +1653,8 @@ template<typename T> class cbuffer{
          */
         T& tail() const{
             if(is_empty())
-                throw empty_queue_exception("Cannot get the tail from an empty queue");
-            return _queue[_tail];
+                throw_empty("Cannot get the tail from an empty queue");
+            return data()[slot(_stored_elements - 1)];
         }
 
         /**
@@ -269,14 +1664,8 @@ template<typename T> class cbuffer{
          * @return true se la coda è piena
          * @return false se la coda non è piena
          */
-        bool is_full() const{
-            if (_head == 0 && _tail == _size - 1) //caso: enqueue fino a rimpiere il buffer
-                return true;
-            
-            if (_head == _tail + 1) // caso: _tail parte da 0 a causa dell'incremento circolare
-                return true;
-            
-            return false;
+        bool is_full() const noexcept{
+            return _size > 0 && _stored_elements == _size;
         }
         /**
          * @brief Funzione che ritorna true o false nel caso
@@ -285,18 +1674,15 @@ template<typename T> class cbuffer{
          * @return true se la coda è vuota
          * @return false se la coda non è vuota
          */
-        bool is_empty() const{
-            if (_head == -1 && _tail == -1)
-                return true;
-            else
-                return false;
+        bool is_empty() const noexcept{
+            return _stored_elements == 0;
         }
         /**
          * @brief Funzione che ritorna la dimensione massima della coda
          * 
          * @return unsigned int dimensione della coda
          */
-        unsigned int size() const{
+        unsigned int size() const noexcept{
             return _size;
         }
         /**
@@ -305,7 +1691,7 @@ template<typename T> class cbuffer{
          * 
          * @return unsigned int 
          */
-        unsigned int stored_elements() const{
+        unsigned int stored_elements() const noexcept{
             return _stored_elements;
         }
 
@@ -318,29 +1704,19 @@ template<typename T> class cbuffer{
          */
         friend std::ostream& operator<<(std::ostream &os, const cbuffer &b){
             if(!b.is_empty()){
-                os<<"Head: " <<b._head <<" - value: ["<< b._queue[b._head] <<"] "<<std::endl;
-                os<<"Tail: "<<b._tail<<" - value: ["<< b._queue[b._tail] <<"] "<<std::endl;
+                int head = b.head_index();
+                int tail = b.tail_index();
+                os<<"Head: " <<head <<" - value: ["<< b.data()[head] <<"] "<<std::endl;
+                os<<"Tail: "<<tail<<" - value: ["<< b.data()[tail] <<"] "<<std::endl;
                 os<<"Size: "<<b.size()<<std::endl;
                 os<<"Stored elements: "<<b.stored_elements()<<std::endl;
-                int head = b._head;
-                int tail = b._tail;
                 os<<"[ ";
-                if(head <= tail){
-                    while(head <= tail){
-                        os << b._queue[head] << " ";
-                        head++;
-                    }
-                }else {
-                    while (head < b.size() ) { //stampo la seconda metà
-                        os<<b._queue[head]<<" ";
-                        head++;
-                    }
-                    head = 0;
-                    while (head <= tail) { //stampo la prima metà
-                        os<<b._queue[head]<<" ";
-                        head++;
-                    }
-                }
+                const_array_range one = b.array_one();
+                const_array_range two = b.array_two();
+                for(unsigned int i = 0; i < one.second; ++i)
+                    os<<one.first[i]<<" ";
+                for(unsigned int i = 0; i < two.second; ++i)
+                    os<<two.first[i]<<" ";
                 unsigned int i = b.stored_elements(); 
                 while(i < b.size()){
                     os<<"# ";
@@ -358,1116 +1734,67 @@ template<typename T> class cbuffer{
          * 
          * @param index indice
          * @return T& riferimento dell'elemento nella posizione index
-         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
          */
         T& operator[](int index){
-            if (index < 0 || index >= _size) 
-				throw std::out_of_range("Cannot call the operator[] due to an index out of bound");
+            if (index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
 
-			return _queue[(_head + index ) % _size];
-		}
+            return data()[slot(index)];
+        }
 
         /**
          * @brief Operator[] const
          * 
          * @param index indice
          * @return T& riferimento dell'elemento nella posizione index
-         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
          */
         const T& operator[](int index) const {
-			if (index < 0 || index >= _size) 
-				throw std::out_of_range("Cannot call the operator[] due to an index out of bound");
-
-			return _queue[(_head + index) % _size];
-		}
-
-        /**
-         * @brief Classe const_iterator
-         * Gli iteratori iterano sui dati contenuti nella coda
-         */
-        class const_iterator;
-
-        class iterator {	
-            public:
-                typedef std::forward_iterator_tag iterator_category;
-                typedef T                         value_type;
-                typedef ptrdiff_t                 difference_type;
-                typedef T*                        pointer;
-                typedef T&                        reference;
-
-                /**
-                 * @brief Costruttore di default
-                 * 
-                 */
-                iterator() : _ptr(nullptr), _cbuffer(nullptr) , _index(-1){}
-
-                /**
-                 * @brief Copy constructor
-                 * 
-                 * @param other iteratore da cui copiare i dati
-                 */
-                iterator(const iterator &other) : _ptr(other._ptr), _cbuffer(other._cbuffer), 
-                    _index(other._index), _distance(other._distance){}
-
-                /**
-                 * @brief Operatore assegnamento
-                 * 
-                 * @param other iteratore da cui copiare i dati
-                 * @return reference all'iteratore this 
-                 */
-                iterator& operator=(const iterator &other) {
-                    _ptr = other._ptr;
-                    _cbuffer = other._cbuffer;
-                    _index = other._index;
-                    _distance = other._distance;
-                    return *this;
-                }
-
-                /**
-                 * @brief Distruttore
-                 * 
-                 */
-                ~iterator() {}
-
-                /**
-                 * @brief Operatore*
-                 * @return reference al dato riferito dall'iteratore (dereferenziamento) 
-                 */
-                reference operator*() const {
-                    return *_ptr;  
-                }
-
-                /**
-                 * @brief Operatore-> 
-                 * 
-                 * @return puntatore al dato riferito dall'iteratore 
-                 */
-                pointer operator->() const {
-                    return _ptr;
-                }
-
-                /**
-                 * @brief Operatore di accesso random
-                 * 
-                 * @param index indice
-                 * @return reference riferimento del valore in posizione index
-                 */
-		        reference operator[](int index) {
-                    if(_cbuffer != nullptr && !_cbuffer->is_empty()){
-                        if(index >= 0){
-                            index = index % _cbuffer->_stored_elements;  
-                        }else{ 
-                            int q = static_cast<int>(floor(static_cast<double>(index) / _cbuffer->_stored_elements));
-                            index =  index - _cbuffer->_stored_elements * q;
-                        }
-
-                        return _cbuffer->_queue[(_index + index) % _cbuffer->_size];  
-                    }
-                    return *_ptr;  
-		        }
-                /**
-                * @brief Operatore++ di post-incremento
-                * @return copia dell'iteratore che punta al valore precedente
-                */
-                iterator operator++(int) {
-                    iterator tmp(*this);
-                    if(_cbuffer != nullptr)
-                        _ptr = next(_ptr);
-                    return tmp;
-                }
-
-                /**
-                 * @brief Operatore++ pre-incremento
-                 * @return reference all'teratore this
-                 */
-                iterator& operator++() {
-                    if(_cbuffer != nullptr)
-                        _ptr = next(_ptr);
-                    return *this;
-                }
-
-                /**
-                 * @brief Operatore di iterazione post-decremento
-                 * 
-                 * @return const_iterator& reference iteratore corrente
-                 */ 
-                iterator operator--(int) {
-                    iterator tmp(*this);
-                    if(_cbuffer != nullptr)
-                        _ptr = previous(_ptr);
-                    return tmp;
-                }
-
-                /**
-                 * @brief Operatore di iterazione pre-decremento
-                 * 
-                 * @return const_iterator& reference iteratore corrente
-                 */
-                iterator &operator--() {
-                    if(_cbuffer != nullptr)
-                        _ptr = previous(_ptr);
-                    return *this;
-                }
-
-                /**
-                 * @brief Spostamento in avanti
-                 * 
-                 * @param offset scostamento
-                 * @return iterator iteratore che punta al nuovo dato
-                 */
-                iterator operator+(int offset) {
-                    int index = offset % _cbuffer->_stored_elements;  
-                    index = (_index + index) % _cbuffer->_size;
-                    iterator tmp = *this;
-                    if(_cbuffer != nullptr && !_cbuffer->is_empty())
-                        return iterator(&tmp[offset], _cbuffer, index, index);
-                    
-                    return *this;
-                      
-                }
-
-                /**
-                 * @brief Spostamento all'indietro
-                 * 
-                 * @param offset scostamento
-                 * @return iterator iteratore che punta al nuovo dato
-                 */
-                iterator operator-(int offset) {
-                    iterator tmp = *this;
-                    return tmp + (- offset); 
-                }
-		
-                /**
-                 * @brief Spostamento in avanti
-                 * 
-                 * @param offset scostamento
-                 * @return iterator& iteratore corrente che punta al nuovo dato
-                 */
-                iterator& operator+=(int offset) {
-                    iterator tmp = *this;
-                    tmp = tmp + offset;
-                    _ptr = tmp._ptr;
-                    _index = tmp._index;
-                    _distance = tmp._distance;
-                    return *this;
-
-                }
+            if (index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
 
-		        /**
-                 * @brief Spostamento all'indietro
-                 * 
-                 * @param offset scostamento
-                 * @return iterator& iteratore corrente che punta al nuovo dato
-                 */
-                iterator& operator-=(int offset) {
-                    iterator tmp = *this;
-                    tmp = tmp - offset;
-                    _ptr = tmp._ptr;
-                    _index = tmp._index;
-                    _distance = tmp._distance;
-                    return *this;
-                }
-
-                /**
-                 * @brief Numero di elementi tra due iteratori
-                 * 
-                 * @param other iteratore other
-                 * @return difference_type 
-                 */
-                difference_type operator-(const iterator &other) {
-                    if(_cbuffer != other._cbuffer)
-                        return difference_type(0);
-                       
-                    if(_cbuffer->_head <= _cbuffer->_tail)// coda lineare
-                        return (_ptr - other._ptr);
-                
-                    return difference_type(_cbuffer->_size) + _ptr - other._ptr;
-                }
-
-                /**
-                 * @brief Operatore==
-                 * 
-                 * @param other iteratore con cui fare il confronto
-                 * @return true se l'iteratore this e other puntano allo stesso dato
-                 * @return false se l'iteratore this e other non puntano allo stesso dato
-                 */
-                bool operator==(const iterator &other) const {
-                    if(_cbuffer){
-                        pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                        pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                        if(_ptr == head && other._ptr == head && _distance > other._distance)
-                            return true;
-                    }
-                    
-                    return (_ptr == other._ptr);
-                }
-
-                /**
-                 * @brief Operatore!=
-                 * 
-                 * @param other iteratore con cui fare il confronto
-                 * @return true se l'iteratore this e other non puntano allo stesso dato
-                 * @return false se l'iteratore this e other puntano allo stesso dato
-                 */
-                bool operator!=(const iterator &other) const {
-                    if(_cbuffer){
-                        std::cout<<_distance << "<=" << other._distance<< std::endl;
-                        pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                        pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                        if(_ptr == head && other._ptr == head && _distance <= other._distance)
-                            return true;
-                    }
-                    return (_ptr != other._ptr);
-                }
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è > dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr > other._ptr); 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) //coda lineare
-                        return (_ptr > other._ptr);
-
-                    return _ptr < other._ptr;//coda circolare
-                }
-		
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è >= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>=(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr >= other._ptr); // return false ?
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail) //coda lineare
-                        return (_ptr >= other._ptr);
-
-                    return _ptr <= other._ptr;//coda circolare
-                }
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è < dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr < other._ptr); // return false ?
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) //coda lineare
-                        return (_ptr < other._ptr);
-
-                    return _ptr > other._ptr;//coda circolare
-                }
-		
-		
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è <= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<=(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr <= other._ptr); // return false ?
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail) //coda lineare
-                        return (_ptr < other._ptr);
-
-                    return _ptr >= other._ptr;//coda circolare
-                }
-                
-                friend class const_iterator;///< friend della classe const_iterator
-
-                /**
-                 * @brief Operatore==
-                 * 
-                 * @param other iteratore costante con cui fare il confronto
-                 * @return true se l'iteratore this e other puntano allo stesso dato
-                 * @return false se l'iteratore this e other non puntano allo stesso dato
-                 */
-		        bool operator==(const const_iterator &other) const {
-			        if(_cbuffer){
-                        pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                        pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                        if(_ptr == head && other._ptr == head && _distance > other._distance)
-                            return true;
-                    }
-                    
-                    return (_ptr == other._ptr);
-
-		        }
-
-                /**
-                 * @brief Operatore!=
-                 * 
-                 * @param other iteratore costante con cui fare il confronto
-                 * @return true se l'iteratore this e other non puntano allo stesso dato
-                 * @return false se l'iteratore this e other puntano allo stesso dato
-                 */
-                bool operator!=(const const_iterator &other) const {
-                    pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                    pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                    if(_ptr == head && other._ptr == head && _distance <= other._distance )
-                        return true;
-
-                    return (_ptr != other._ptr);
-                }
-        
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è > dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer) 
-                        return _ptr > other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) 
-                        return _ptr > other._ptr;
-
-                    return _ptr < other._ptr;
-                }
-		
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è >= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>=(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer) 
-                        return _ptr >= other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail) 
-                        return _ptr >= other._ptr;
-
-                    return _ptr <= other._ptr;
-                }
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è < dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer) 
-                        return _ptr < other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) 
-                        return _ptr < other._ptr;
-
-                    return _ptr > other._ptr;
-                }
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è <= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<=(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer)
-                        return _ptr <= other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail)
-                        return _ptr <= other._ptr;
-
-                    return _ptr >= other._ptr;
-                }
-
-           // private:
-                friend class cbuffer;///< friend della classe cbuffer
-                cbuffer *_cbuffer;///< puntatore al cbuffer corrente
-                T *_ptr;///< puntatore al valore
-                int _index;///< posizione nell'array del valore puntato da _ptr
-                unsigned int _distance;///< distanza del puntatore dalla testa
-                
-                
-                /**
-                 * @brief Costruttore privato
-                 * 
-                 * @param q puntatore di tipo cbuffer
-                 * @param ptr puntatore al valore
-                 * @param index indice del puntatore ptr
-                 */
-                iterator(T *ptr, cbuffer *q, int index, unsigned int distance)
-                    : _cbuffer(q), _ptr(ptr), _index(index), _distance(distance){}
-
-                /**
-                 * @brief Funzione che sposta il puntatore di una posizione in avanti
-                 * 
-                 * @param ptr puntatore da spostare
-                 * @return T* puntatore spostato
-                 */
-                T* next(T* ptr){
-                    if(ptr == &_cbuffer->_queue[_cbuffer->_tail]){
-                        if(_distance == _cbuffer->_size - 1)
-                            _distance = _index;
-
-                        ptr = &_cbuffer->_queue[_cbuffer->_head];
-                        _index = _cbuffer->_head;
-                        _distance = (_distance + 1) % (_cbuffer->_size + 1);
-                        
-                    }else{
-                        ptr = &_cbuffer->_queue[(_index + 1) % _cbuffer->_size];
-                        _index = (_index + 1) % _cbuffer->_size;
-                       _distance = (_distance + 1) % _cbuffer->_size;
-                        
-                    }
-                    return ptr;
-                }
-                /**
-                 * @brief Funzione che sposta il puntatore di una posizione in dietro
-                 * 
-                 * @param ptr puntatore da spostare
-                 * @return const T* const puntatore spostato
-                 */
-                T* previous(T* ptr){
-                    int prev  = (_index - 1) % _cbuffer->_stored_elements; 
-                    int q = static_cast<int>(floor(static_cast<double>(prev) / _cbuffer->_stored_elements));
-                    prev = prev - _cbuffer->_stored_elements * q;
-                    if(ptr == &_cbuffer->_queue[_cbuffer->_head]){
-                        ptr = &_cbuffer->_queue[_cbuffer->_tail];
-                        _index = _cbuffer->_tail;
-                        _distance = _cbuffer->_tail;
-                    }else{
-                        ptr = &_cbuffer->_queue[(_index - 1) % _cbuffer->_size];
-                        _index = (_index - 1) % _cbuffer->_size;
-                        _distance --;
-                        
-                    }
-                    
-                    return ptr;  
-                }
-        
-            
-        }; // classe iterator
-        
-        /**
-         * @brief Classe const_iterator
-         * Gli iteratori iterano sui dati contenuti nella coda
-         * 
-         */
-        class const_iterator {
-            
-            public:
-                typedef std::forward_iterator_tag iterator_category;
-                typedef T                         value_type;
-                typedef ptrdiff_t                 difference_type;
-                typedef const T*                  pointer;
-                typedef const T&                  reference;
-                
-                /**
-                 * @brief Costruttore di default 
-                 */
-                const_iterator() : _ptr(nullptr), _cbuffer(nullptr), _index(-1){}
-
-                /**
-                 * @brief Copy constructor
-                 * @param other iteratore da cui copiare i dati
-                 */
-                const_iterator(const const_iterator &other) : _ptr(other._ptr), _cbuffer(other._cbuffer),
-                    _index(other._index), _distance(other._distance){}
-
-                /**
-                 * @brief Operatore assegnamento
-                 * 
-                 * @param other iteratore da cui copiare i dati
-                 * @return reference all'iteratore this 
-                 */
-                const_iterator& operator=(const const_iterator &other) {
-                    _ptr = other._ptr;
-                    _cbuffer = other._cbuffer;
-                    _index = other._index;
-                    _distance = other._distance;
-                    return *this;
-                }
-
-                /**
-                 * @brief Costruttore di conversione iterator -> const_iterator
-                 * 
-                 * @param other iteratore
-                 */
-                const_iterator(const iterator &other) {
-                    _ptr = other._ptr;
-                    _cbuffer = other._cbuffer;
-                    _index = other._index;
-                    _distance = other._distance;
-                }
-
-                /**
-                 * @brief Distruttore
-                 * 
-                 */
-                ~const_iterator() {}
-
-                /**
-                 * @brief Operatore*
-                 * 
-                 * @return reference al dato riferito dall'iteratore (dereferenziamento) 
-                 */
-                reference operator*() const {
-                    return *_ptr;
-                }
-
-                /**
-                 * @brief Operatore-> 
-                 * 
-                 * @return puntatore al dato riferito dall'iteratore 
-                 */
-                pointer operator->() const {
-                    return _ptr;
-                }
-                
-                /**
-                 * @brief Operatore di accesso random
-                 * 
-                 * @param index indice
-                 * @return reference riferimento del valore in posizione index
-                 */
-                reference operator[](int index) {
-                    if(_cbuffer != nullptr && !_cbuffer->is_empty()){
-                        if(index >= 0){
-                            index = index % _cbuffer->_stored_elements;  
-                        }else{ 
-                            int q = static_cast<int>(floor(static_cast<double>(index) / _cbuffer->_stored_elements));
-                            index =  index - _cbuffer->_stored_elements * q;
-                        }  
-                        return _cbuffer->_queue[(_index + index) % _cbuffer->_size];  
-                    }
-                    return *_ptr; 
-                }
-                
-                /**
-                 * @brief Operatore++ di post-incremento
-                 * @return copia dell'iteratore che punta al valore precedente
-                 */
-                const_iterator operator++(int) {
-                    const_iterator tmp(*this);
-                    if(_cbuffer != nullptr)
-                        _ptr = next(_ptr);
-                    return tmp;
-                }
-
-                /**
-                 * @brief Operatore++ pre-incremento
-                 * @return reference all'teratore this
-                 */
-                const_iterator& operator++() {
-                    if(_cbuffer != nullptr)
-                        _ptr = next(_ptr);
-                    
-                    return *this;
-                }
-
-                /**
-                 * @brief Operatore di iterazione post-decremento
-                 * 
-                 * @return const_iterator& reference iteratore corrente
-                 */
-                const_iterator operator--(int) {
-                    const_iterator tmp(*this);
-                    if(_cbuffer != nullptr)
-                        _ptr = previous(_ptr);
-                    return tmp;
-                }
-
-                /**
-                 * @brief Operatore di iterazione pre-decremento
-                 * 
-                 * @return const_iterator& reference iteratore corrente
-                 */
-                const_iterator &operator--() {
-                    if(_cbuffer != nullptr)
-                        _ptr = previous(_ptr);
-                    return *this;
-                }
-
-                /**
-                 * @brief Spostamento in avanti
-                 * 
-                 * @param offset scostamento
-                 * @return const_iterator iteratore che punta al nuovo dato
-                 */
-                const_iterator operator+(int offset) {
-                    int index = offset % _cbuffer->_stored_elements;  
-                    index = (_index + index) % _cbuffer->_size;
-                    const_iterator tmp = *this;
-                    if(_cbuffer != nullptr && !_cbuffer->is_empty())
-                        return const_iterator(&tmp[offset], _cbuffer, index, index);
-                    
-                    return *this;
-                }
-
-               /**
-                 * @brief Spostamento all'indietro
-                 * 
-                 * @param offset scostamento
-                 * @return const_iterator iteratore che punta al nuovo dato
-                 */
-                const_iterator operator-(int offset) {
-                    const_iterator tmp = *this;
-                    return tmp + (- offset);
-                }
-                
-                /**
-                 * @brief Spostamento in avanti
-                 * 
-                 * @param offset scostamento
-                 * @return const_iterator& iteratore corrente che punta al nuovo dato
-                 */
-                const_iterator& operator+=(int offset) {
-                    const_iterator tmp = *this;
-                    tmp = tmp + offset;
-                    _ptr = tmp._ptr;
-                    _index = tmp._index;
-                    _distance = tmp._distance;
-                    return *this;
-                }
-
-                /**
-                 * @brief Spostamento all'indietro
-                 * 
-                 * @param offset scostamento
-                 * @return const_iterator& iteratore corrente che punta al nuovo dato
-                 */
-                const_iterator& operator-=(int offset) {
-                    const_iterator tmp = *this;
-                    tmp = tmp - offset;
-                    _ptr = tmp._ptr;
-                    _index = tmp._index;
-                    _distance = tmp._distance;
-                    return *this;
-                }
-
-               /**
-                 * @brief Numero di elementi tra due iteratori
-                 * 
-                 * @param other iteratore costante other
-                 * @return difference_type 
-                 */
-                difference_type operator-(const const_iterator &other) {
-                    if(_cbuffer != other._cbuffer)
-                        return difference_type(0);
-                       
-                    if(_cbuffer->_head <= _cbuffer->_tail)// coda lineare
-                        return (_ptr - other._ptr);
-                
-                    return difference_type(_cbuffer->_size) + _ptr - other._ptr;
-                }
-
-                /**
-                 * @brief Operatore==
-                 * 
-                 * @param other iteratore costante con cui fare il confronto
-                 * @return true se l'iteratore this e other puntano allo stesso dato
-                 * @return false se l'iteratore this e other non puntano allo stesso dato
-                 */
-                bool operator==(const const_iterator &other) const {
-                    if(_cbuffer){
-                        pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                        pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                        if(_ptr == head && other._ptr == head && _distance > other._distance)
-                            return true;
-                    }
-                    
-                    return (_ptr == other._ptr);
-
-                }
-                
-                /**
-                 * @brief Operatore!=
-                 * next
-                 * @param other iteratore costante con cui fare il confronto
-                 * @return true se l'iteratore this e other non puntano allo stesso dato
-                 * @return false se l'iteratore this e other puntano allo stesso dato
-                 */
-                bool operator!=(const const_iterator &other) const {
-                    if(_cbuffer){
-                        pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                        pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                        if(_ptr == head && other._ptr == head && _distance <= other._distance)
-                            return true;
-                    }
-                    return (_ptr != other._ptr);
-                }
-
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è > dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr > other._ptr); 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) //coda lineare
-                        return (_ptr > other._ptr);
-
-                    return _ptr < other._ptr;//coda circolare
-                }
-                
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è >= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>=(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr >= other._ptr); // return false ?
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail) //coda lineare
-                        return (_ptr >= other._ptr);
-
-                    return _ptr <= other._ptr;//coda circolare
-                }
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è < dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr < other._ptr); // return false ?
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) //coda lineare
-                        return (_ptr < other._ptr);
-
-                    return _ptr > other._ptr;//coda circolare
-                }
-                
-                
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other const_iterator
-                 * @return true se l'iteratore corrente è <= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<=(const const_iterator &other) const {
-                    if(_cbuffer != other._cbuffer) //puntano a cbuffer diversi
-                        return (_ptr <= other._ptr); // return false ?
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail) //coda lineare
-                        return (_ptr < other._ptr);
-
-                    return _ptr >= other._ptr;//coda circolare
-                }
-                
-                
-                friend class iterator;///< friend della classe iterator
-
-                /**
-                 * @brief Operatore==
-                 * 
-                 * @param other iteratore con cui fare il confronto
-                 * @return true se l'iteratore this e other puntano allo stesso dato
-                 * @return false se l'iteratore this e other non puntano allo stesso dato
-                 */
-                bool operator==(const iterator &other) const {
-                    if(_cbuffer){
-                        pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                        pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                        if(_ptr == head && other._ptr == head && _distance > other._distance)
-                            return true;
-                    }
-                    
-                    return (_ptr == other._ptr);
-
-                }
-
-                /**
-                 * @brief Operatore!=
-                 * 
-                 * @param other iteratore con cui fare il confronto
-                 * @return true se l'iteratore this e other non puntano allo stesso dato
-                 * @return false se l'iteratore this e other puntano allo stesso dato
-                 */
-                bool operator!=(const iterator &other) const {
-                    if(_cbuffer){
-                        pointer tail = &_cbuffer->_queue[_cbuffer->_tail];
-                        pointer head = &_cbuffer->_queue[_cbuffer->_head];
-                        if(_ptr == head && other._ptr == head && _distance <= other._distance)
-                            return true;
-                    }
-                    return (_ptr != other._ptr);
-                }
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è > dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer) 
-                        return _ptr > other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) 
-                        return _ptr > other._ptr;
-
-                    return _ptr < other._ptr;
-                }
-		
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è >= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator>=(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer) 
-                        return _ptr >= other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail) 
-                        return _ptr >= other._ptr;
-
-                    return _ptr <= other._ptr;
-                }
-
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è < dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer) 
-                        return _ptr < other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head < _cbuffer->_tail) 
-                        return _ptr < other._ptr;
-
-                    return _ptr > other._ptr;
-                }
-		
-		
-                /**
-                 * @brief Operatore di confronto
-                 * 
-                 * @param other iterator
-                 * @return true se l'iteratore corrente è <= dell'iteratore other
-                 * @return false altrimenti
-                 */
-                bool operator<=(const iterator &other) const {
-                    if(_cbuffer != other._cbuffer)
-                        return _ptr <= other._ptr; 
-
-                    if(_cbuffer == nullptr)
-                        return false;
-
-                    if(_cbuffer->_head <= _cbuffer->_tail)
-                        return _ptr <= other._ptr;
-
-                    return _ptr >= other._ptr;
-                }
+            return data()[slot(index)];
+        }
 
+        typedef cbuffer_iterator<cbuffer, T> iterator; ///< iteratore ad accesso casuale sui dati
+        typedef cbuffer_iterator<const cbuffer, const T> const_iterator; ///< iteratore costante ad accesso casuale sui dati
 
-                /**
-                 * @brief Assegnamento di un iterator ad un const_iterator
-                 * 
-                 * @param other oggetto di tipo iterator
-                 * @return const_iterator& riferimento al const_iterator this
-                 */
-                const_iterator &operator=(const iterator &other) {
-                    _ptr = other._ptr;
-                    _cbuffer = other._cbuffer;
-                    _index = other._index;
-                    _distance = other._distance;
-                    return *this;
-                }
 
-            private:
-                friend class cbuffer;///< friend della classe cbuffer
-                const cbuffer* _cbuffer;///< puntatore al cbuffer corrente
-                const T *_ptr;///< puntatore al dato
-                int _index;///< posizione nell'array del valore puntato da _ptr
-                unsigned int _distance;///< distanza del puntatore dalla testa
-               
-                /**
-                 * @brief Costruttore privato
-                 * 
-                 * @param q puntatore di tipo cbuffer
-                 * @param ptr puntatore al valore
-                 * @param index indice del puntatore ptr
-                 */
-                const_iterator(const T *ptr, const cbuffer* const q, int index, unsigned int distance)
-                    : _cbuffer(q), _ptr(ptr), _index(index), _distance(distance){}
-
-                /**
-                 * @brief Funzione che sposta il puntatore di una posizione in avanti
-                 * 
-                 * @param ptr puntatore da spostare
-                 * @return const T* const puntatore spostato
-                 */
-                const T* const next(const T* ptr){
-                   if(ptr == &_cbuffer->_queue[_cbuffer->_tail]){
-                        if(_distance == _cbuffer->_size - 1)
-                            _distance = _index;
-
-                        ptr = &_cbuffer->_queue[_cbuffer->_head];
-                        _index = _cbuffer->_head;
-                        _distance = (_distance + 1) % (_cbuffer->_size + 1);
-                        
-                    }else{
-                        ptr = &_cbuffer->_queue[(_index + 1) % _cbuffer->_size];
-                        _index = (_index + 1) % _cbuffer->_size;
-                       _distance = (_distance + 1) % _cbuffer->_size;
-                        
-                    }
-                    return ptr;
-                }
-                /**
-                 * @brief Funzione che sposta il puntatore di una posizione in dietro
-                 * 
-                 * @param ptr puntatore da spostare
-                 * @return const T* const puntatore spostato
-                 */
-                const T* const previous(const T* ptr){
-                    int prev  = (_index - 1) % _cbuffer->_stored_elements; 
-                    int q = static_cast<int>(floor(static_cast<double>(prev) / _cbuffer->_stored_elements));
-                    prev = prev - _cbuffer->_stored_elements * q;
-                    if(ptr == &_cbuffer->_queue[_cbuffer->_head]){
-                        ptr = &_cbuffer->_queue[_cbuffer->_tail];
-                        _index = _cbuffer->_tail;
-                        _distance = _cbuffer->_tail;
-                        
-                    }else{
-                        ptr = &_cbuffer->_queue[(_index - 1) % _cbuffer->_size];
-                        _index = (_index - 1) % _cbuffer->_size;
-                        _distance --;  
-                    }
-                }
-                      
-            
-        }; // classe const_iterator
-         
-        
         /**
          * @brief Iteratore di inizio
-         * 
-         * @return iterator 
+         *
+         * @return iterator che punta alla testa
          */
-        iterator begin() { 
-            if(_head > -1)
-                return iterator(_queue + _head, this, _head, _head);
-            else
-                return iterator(nullptr, this, _head, _head);
+        iterator begin() {
+            return iterator(this, 0);
         }
-        
+
         /**
          * @brief Iteratore fine
-         * 
-         * @return iterator
+         *
+         * @return iterator che punta dopo la coda
          */
         iterator end() {
-            if(is_empty())
-                return iterator(nullptr, this, _tail, _tail);
-            else
-                return iterator(_queue + _head , this, _head, _tail);
-           
+            return iterator(this, _stored_elements);
         }
 
         /**
          * @brief Iteratore di inzio
-         * 
-         * @return const_iterator
+         *
+         * @return const_iterator che punta alla testa
          */
         const_iterator begin() const {
-            if(_head > -1)
-                return const_iterator(_queue + _head, this, _head, _head);
-            else
-                return const_iterator(nullptr, this, _head, _head);
+            return const_iterator(this, 0);
         }
-        
+
         /**
          * @brief Iteratore fine
-         * 
-         * @return const_iterator
+         *
+         * @return const_iterator che punta dopo la coda
          */
         const_iterator end() const{
-            if(is_empty())
-                return const_iterator(nullptr, this, _tail, _tail);
-            else
-                return const_iterator(_queue + _head , this, _head, _tail);
+            return const_iterator(this, _stored_elements);
         }
 };
 
@@ -0,0 +1,209 @@
+#ifndef CBUFFER_ALGORITHM_H
+#define CBUFFER_ALGORITHM_H
+#include <algorithm>
+#include <numeric>
+#include <cstddef> // std::ptrdiff_t
+#include <utility> // std::move
+#include "cbuffer.h"
+/**
+ * @file cbuffer_algorithm.h
+ * @brief Versioni segmentate degli algoritmi della STL per cbuffer
+ *
+ * Ogni algoritmo prende il cbuffer intero e lavora sui (al più due)
+ * segmenti contigui dei dati con puntatori semplici, invece di
+ * attraversare la coda con gli iteratori: il calcolo dello slot
+ * non compare nel ciclo interno e il compilatore può vettorizzarlo.
+ * Il risultato è lo stesso dell'algoritmo della STL applicato a
+ * [begin(), end()), incluso l'ordine delle operazioni.
+ */
+
+/**
+ * @brief Funzione di supporto che cerca il primo elemento che
+ * soddisfa p, un segmento alla volta
+ *
+ * @tparam Buffer tipo del cbuffer (const o non const)
+ * @tparam Predicate tipo del predicato
+ * @param b cbuffer in cui cercare
+ * @param p predicato
+ * @return iteratore all'elemento trovato, end() se non esiste
+ */
+template<typename Buffer, typename Predicate> auto find_if_segments(Buffer &b, Predicate p) -> decltype(b.begin()){
+    auto one = b.array_one();
+    auto two = b.array_two();
+    auto found = std::find_if(one.first, one.first + one.second, p);
+    if(found != one.first + one.second)
+        return b.begin() + (found - one.first);
+    found = std::find_if(two.first, two.first + two.second, p);
+    return b.begin() + (one.second + (found - two.first)); // non trovato: one + two = end()
+}
+
+/**
+ * @brief Funzione che applica f a ogni elemento della coda in ordine FIFO
+ *
+ * @tparam F tipo della funzione, invocabile come f(T&)
+ * @param b cbuffer da visitare
+ * @param f funzione da applicare
+ * @return F la funzione f dopo le chiamate
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename F>
+F for_each(cbuffer<T, Index, Overflow, Allocator> &b, F f){
+    b.for_each_segment([&f](T *first, T *last){
+        for(; first != last; ++first)
+            f(*first);
+    });
+    return f;
+}
+
+/**
+ * @brief Funzione che applica f a ogni elemento della coda in ordine FIFO
+ *
+ * @tparam F tipo della funzione, invocabile come f(const T&)
+ * @param b cbuffer da visitare
+ * @param f funzione da applicare
+ * @return F la funzione f dopo le chiamate
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename F>
+F for_each(const cbuffer<T, Index, Overflow, Allocator> &b, F f){
+    b.for_each_segment([&f](const T *first, const T *last){
+        for(; first != last; ++first)
+            f(*first);
+    });
+    return f;
+}
+
+/**
+ * @brief Funzione che somma gli elementi della coda a init in ordine FIFO
+ *
+ * @tparam Init tipo dell'accumulatore
+ * @param b cbuffer da sommare
+ * @param init valore iniziale
+ * @return Init init + b[0] + ... + b[stored_elements() - 1]
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename Init>
+Init accumulate(const cbuffer<T, Index, Overflow, Allocator> &b, Init init){
+    b.for_each_segment([&init](const T *first, const T *last){
+        init = std::accumulate(first, last, std::move(init));
+    });
+    return init;
+}
+
+/**
+ * @brief Funzione che combina gli elementi della coda con op in ordine FIFO
+ *
+ * @tparam Init tipo dell'accumulatore
+ * @tparam BinaryOp tipo dell'operazione, invocabile come op(Init, const T&)
+ * @param b cbuffer da ridurre
+ * @param init valore iniziale
+ * @param op operazione binaria
+ * @return Init risultato della riduzione
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename Init, typename BinaryOp>
+Init accumulate(const cbuffer<T, Index, Overflow, Allocator> &b, Init init, BinaryOp op){
+    b.for_each_segment([&init, &op](const T *first, const T *last){
+        init = std::accumulate(first, last, std::move(init), op);
+    });
+    return init;
+}
+
+/**
+ * @brief Funzione che cerca il primo elemento che soddisfa p
+ *
+ * @tparam Predicate tipo del predicato, invocabile come p(const T&)
+ * @param b cbuffer in cui cercare
+ * @param p predicato
+ * @return iterator all'elemento trovato, end() se non esiste
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename Predicate>
+typename cbuffer<T, Index, Overflow, Allocator>::iterator find_if(cbuffer<T, Index, Overflow, Allocator> &b, Predicate p){
+    return find_if_segments(b, p);
+}
+
+/**
+ * @brief Funzione che cerca il primo elemento che soddisfa p
+ *
+ * @tparam Predicate tipo del predicato, invocabile come p(const T&)
+ * @param b cbuffer in cui cercare
+ * @param p predicato
+ * @return const_iterator all'elemento trovato, end() se non esiste
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename Predicate>
+typename cbuffer<T, Index, Overflow, Allocator>::const_iterator find_if(const cbuffer<T, Index, Overflow, Allocator> &b, Predicate p){
+    return find_if_segments(b, p);
+}
+
+/**
+ * @brief Funzione che cerca il primo elemento uguale a value
+ *
+ * @tparam U tipo del valore (confrontabile con T tramite ==)
+ * @param b cbuffer in cui cercare
+ * @param value valore da cercare
+ * @return iterator all'elemento trovato, end() se non esiste
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename U>
+typename cbuffer<T, Index, Overflow, Allocator>::iterator find(cbuffer<T, Index, Overflow, Allocator> &b, const U &value){
+    return find_if_segments(b, [&value](const T &element){ return element == value; });
+}
+
+/**
+ * @brief Funzione che cerca il primo elemento uguale a value
+ *
+ * @tparam U tipo del valore (confrontabile con T tramite ==)
+ * @param b cbuffer in cui cercare
+ * @param value valore da cercare
+ * @return const_iterator all'elemento trovato, end() se non esiste
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename U>
+typename cbuffer<T, Index, Overflow, Allocator>::const_iterator find(const cbuffer<T, Index, Overflow, Allocator> &b, const U &value){
+    return find_if_segments(b, [&value](const T &element){ return element == value; });
+}
+
+/**
+ * @brief Funzione che conta gli elementi che soddisfano p
+ *
+ * @tparam Predicate tipo del predicato, invocabile come p(const T&)
+ * @param b cbuffer da visitare
+ * @param p predicato
+ * @return std::ptrdiff_t numero di elementi che soddisfano p
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename Predicate>
+std::ptrdiff_t count_if(const cbuffer<T, Index, Overflow, Allocator> &b, Predicate p){
+    std::ptrdiff_t n = 0;
+    b.for_each_segment([&n, &p](const T *first, const T *last){
+        n += std::count_if(first, last, p);
+    });
+    return n;
+}
+
+/**
+ * @brief Funzione che conta gli elementi uguali a value
+ *
+ * @tparam U tipo del valore (confrontabile con T tramite ==)
+ * @param b cbuffer da visitare
+ * @param value valore da contare
+ * @return std::ptrdiff_t numero di elementi uguali a value
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename U>
+std::ptrdiff_t count(const cbuffer<T, Index, Overflow, Allocator> &b, const U &value){
+    return count_if(b, [&value](const T &element){ return element == value; });
+}
+
+/**
+ * @brief Funzione che scrive in out il risultato di op su ogni
+ * elemento della coda, in ordine FIFO
+ *
+ * @tparam OutputIt tipo dell'iteratore di output
+ * @tparam UnaryOp tipo dell'operazione, invocabile come op(const T&)
+ * @param b cbuffer sorgente
+ * @param out iteratore di output (almeno stored_elements() posizioni)
+ * @param op operazione da applicare
+ * @return OutputIt iteratore dopo l'ultimo elemento scritto
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator, typename OutputIt, typename UnaryOp>
+OutputIt transform(const cbuffer<T, Index, Overflow, Allocator> &b, OutputIt out, UnaryOp op){
+    b.for_each_segment([&out, &op](const T *first, const T *last){
+        out = std::transform(first, last, out, op);
+    });
+    return out;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef CBUFFER_INDEX_H
+#define CBUFFER_INDEX_H
+#include <stdexcept> // std::length_error
+/**
+ * @brief Politica di indicizzazione di default
+ *
+ * La capacità della coda è quella richiesta e la posizione nell'array
+ * si ottiene con l'operazione di modulo. Il contatore della testa
+ * rimane sempre nell'intervallo [0, size).
+ */
+struct modulo_index{
+    /**
+     * @brief Funzione che ritorna la capacità effettiva della coda
+     *
+     * @param size capacità richiesta
+     * @return unsigned int capacità effettiva (uguale a size)
+     */
+    static unsigned int capacity(unsigned int size){
+        return size;
+    }
+
+    /**
+     * @brief Funzione che ritorna la posizione nell'array del contatore counter
+     *
+     * @param counter contatore logico
+     * @param size capacità della coda
+     * @return unsigned int posizione nell'array
+     */
+    static unsigned int slot(unsigned int counter, unsigned int size){
+        return counter % size;
+    }
+
+    /**
+     * @brief Funzione che sposta in avanti un contatore di n posizioni
+     *
+     * @param counter contatore da spostare
+     * @param n numero di posizioni
+     * @param size capacità della coda
+     * @return unsigned int contatore spostato (ridotto modulo size)
+     */
+    static unsigned int advance(unsigned int counter, unsigned int n, unsigned int size){
+        return (counter + n) % size;
+    }
+};
+
+/**
+ * @brief Politica di indicizzazione a potenze di due
+ *
+ * La capacità della coda viene arrotondata alla potenza di due
+ * successiva, i contatori crescono in modo monotono (l'overflow
+ * dell'unsigned è compatibile con la maschera) e la posizione
+ * nell'array si ottiene con un AND bit a bit al posto del modulo.
+ */
+struct pow2_index{
+    static constexpr unsigned int max_capacity = 1u << 31; ///< potenza di due più grande rappresentabile
+
+    /**
+     * @brief Funzione che ritorna la capacità effettiva della coda
+     *
+     * @param size capacità richiesta
+     * @return unsigned int la più piccola potenza di due >= size (0 se size == 0)
+     * @throw std::length_error eccezione lanciata se size > max_capacity
+     */
+    static unsigned int capacity(unsigned int size){
+        if(size == 0)
+            return 0;
+        if(size > max_capacity) // altrimenti c raggiungerebbe 0 e il ciclo non terminerebbe
+            throw std::length_error("Cannot round a capacity above 2^31 to a power of two");
+        unsigned int c = 1;
+        while(c < size)
+            c <<= 1;
+        return c;
+    }
+
+    /**
+     * @brief Funzione che ritorna la posizione nell'array del contatore counter
+     *
+     * @param counter contatore logico
+     * @param size capacità della coda (potenza di due)
+     * @return unsigned int posizione nell'array
+     */
+    static unsigned int slot(unsigned int counter, unsigned int size){
+        return counter & (size - 1);
+    }
+
+    /**
+     * @brief Funzione che sposta in avanti un contatore di n posizioni
+     *
+     * @param counter contatore da spostare
+     * @param n numero di posizioni
+     * @param size capacità della coda (non usata)
+     * @return unsigned int contatore spostato (non ridotto)
+     */
+    static unsigned int advance(unsigned int counter, unsigned int n, unsigned int){
+        return counter + n;
+    }
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef CBUFFER_OVERFLOW_H
+#define CBUFFER_OVERFLOW_H
+/**
+ * @brief Politica di inserimento su coda piena: l'elemento più vecchio
+ * viene sovrascritto (comportamento di default di cbuffer)
+ */
+struct overwrite_on_full{};
+
+/**
+ * @brief Politica di inserimento su coda piena: l'inserimento viene
+ * rifiutato e la funzione di inserimento ritorna false
+ * (comportamento di default di spsc_cbuffer e mpmc_cbuffer)
+ */
+struct reject_on_full{};
+
+/**
+ * @brief Politica di inserimento su coda piena: il thread produttore
+ * attende che un consumatore liberi uno slot. Disponibile solo per
+ * le code concorrenti (spsc_cbuffer e mpmc_cbuffer)
+ */
+struct block_on_full{};
+
+/**
+ * @brief Politica di inserimento su coda piena: la capacità viene
+ * raddoppiata e gli elementi vengono spostati in un nuovo array, quindi
+ * la coda si comporta come una FIFO illimitata con inserimento in O(1)
+ * ammortizzato. Disponibile solo per cbuffer
+ */
+struct grow_on_full{};
+
+#endif
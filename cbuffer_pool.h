@@ -0,0 +1,259 @@
+#ifndef CBUFFER_POOL_H
+#define CBUFFER_POOL_H
+#include <cstddef> // std::size_t
+#include <memory_resource> // std::pmr::memory_resource, std::pmr::new_delete_resource
+#include <vector>
+/**
+ * @brief Classe block_pool
+ *
+ * Risorsa di memoria (std::pmr::memory_resource) che ricicla blocchi di
+ * dimensione fissa: i blocchi liberati vengono tenuti in una lista per
+ * ogni coppia (dimensione, allineamento) e riutilizzati dalle allocazioni
+ * successive della stessa dimensione, senza passare dalla risorsa a monte.
+ * È pensata per le code create e distrutte di continuo con poche capacità
+ * ricorrenti (ad esempio una finestra per connessione): dopo il
+ * riscaldamento creare una coda non chiama malloc.
+ *
+ * Vengono riciclate al più max_classes dimensioni diverse (le prime
+ * richieste) e al più max_blocks blocchi liberi per dimensione; le altre
+ * allocazioni passano direttamente alla risorsa a monte.
+ *
+ * La classe non è thread-safe: si usa un pool per thread (vedi local()
+ * e pool_allocator) oppure un pool protetto dall'utente.
+ */
+class block_pool : public std::pmr::memory_resource{
+
+    /**
+     * @brief Lista dei blocchi liberi di una dimensione
+     */
+    struct size_class{
+        std::size_t bytes; ///< dimensione dei blocchi
+        std::size_t alignment; ///< allineamento dei blocchi
+        std::vector<void*> free; ///< blocchi liberi (capacità riservata max_blocks)
+    };
+
+    std::vector<size_class> _classes; ///< dimensioni riciclate
+    std::size_t _max_classes; ///< numero massimo di dimensioni riciclate
+    std::size_t _max_blocks; ///< numero massimo di blocchi liberi per dimensione
+    std::pmr::memory_resource *_upstream; ///< risorsa da cui provengono i blocchi
+
+    /**
+     * @brief Funzione di supporto che cerca la lista dei blocchi di
+     * dimensione bytes e allineamento alignment
+     *
+     * @return size_class* lista trovata, nullptr se la dimensione non è riciclata
+     */
+    size_class* find(std::size_t bytes, std::size_t alignment){
+        for(size_class &c : _classes)
+            if(c.bytes == bytes && c.alignment == alignment)
+                return &c;
+        return nullptr;
+    }
+
+    /**
+     * @brief Struttura che possiede il pool del thread e ne segnala la
+     * distruzione, così che le deallocazioni successive (ad esempio da
+     * code globali) non usino un pool già distrutto
+     */
+    struct local_holder;
+
+    /**
+     * @brief Funzione di supporto che ritorna il flag di distruzione del
+     * pool del thread
+     *
+     * @return bool& true se il pool del thread è già stato distrutto
+     */
+    static bool& local_destroyed() noexcept{
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    protected:
+        /**
+         * @brief Funzione che alloca un blocco, riusando se possibile un
+         * blocco libero della stessa dimensione
+         *
+         * @param bytes dimensione del blocco
+         * @param alignment allineamento del blocco
+         * @return void* blocco allocato
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita
+         */
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override{
+            size_class *c = find(bytes, alignment);
+            if(c != nullptr && !c->free.empty()){
+                void *p = c->free.back();
+                c->free.pop_back();
+                return p;
+            }
+            if(c == nullptr && _classes.size() < _max_classes){
+                // la lista viene creata qui, così do_deallocate non alloca mai
+                _classes.push_back(size_class{bytes, alignment, std::vector<void*>()});
+                _classes.back().free.reserve(_max_blocks);
+            }
+            return _upstream->allocate(bytes, alignment);
+        }
+
+        /**
+         * @brief Funzione che libera un blocco: viene tenuto per le
+         * allocazioni successive se la sua dimensione è riciclata e la
+         * lista non è piena, altrimenti viene restituito alla risorsa a monte
+         *
+         * @param p blocco da liberare
+         * @param bytes dimensione del blocco
+         * @param alignment allineamento del blocco
+         */
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override{
+            size_class *c = find(bytes, alignment);
+            if(c != nullptr && c->free.size() < _max_blocks)
+                c->free.push_back(p);
+            else
+                _upstream->deallocate(p, bytes, alignment);
+        }
+
+        /**
+         * @brief Due pool sono uguali solo se sono lo stesso oggetto
+         *
+         * @param other risorsa da confrontare
+         * @return bool true se other è questo pool
+         */
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override{
+            return this == &other;
+        }
+
+    public:
+        /**
+         * @brief Costruttore
+         *
+         * @param max_blocks numero massimo di blocchi liberi tenuti per dimensione
+         * @param max_classes numero massimo di dimensioni riciclate
+         * @param upstream risorsa da cui provengono i blocchi
+         */
+        explicit block_pool(std::size_t max_blocks = 64, std::size_t max_classes = 16,
+            std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+            : _max_classes(max_classes), _max_blocks(max_blocks), _upstream(upstream){}
+
+        block_pool(const block_pool &other) = delete;
+        block_pool& operator=(const block_pool &other) = delete;
+
+        /**
+         * @brief Distruttore: restituisce i blocchi liberi alla risorsa a
+         * monte. I blocchi ancora in uso devono essere già stati liberati.
+         */
+        ~block_pool(){
+            release();
+        }
+
+        /**
+         * @brief Funzione che restituisce alla risorsa a monte tutti i
+         * blocchi liberi. Le dimensioni restano riciclate.
+         */
+        void release() noexcept{
+            for(size_class &c : _classes){
+                for(void *p : c.free)
+                    _upstream->deallocate(p, c.bytes, c.alignment);
+                c.free.clear();
+            }
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di blocchi liberi in attesa
+         * di essere riutilizzati
+         *
+         * @return std::size_t numero di blocchi liberi
+         */
+        std::size_t cached_blocks() const{
+            std::size_t n = 0;
+            for(const size_class &c : _classes)
+                n += c.free.size();
+            return n;
+        }
+
+        /**
+         * @brief Funzione che ritorna la risorsa a monte
+         *
+         * @return std::pmr::memory_resource* risorsa da cui provengono i blocchi
+         */
+        std::pmr::memory_resource* upstream() const{
+            return _upstream;
+        }
+
+        /**
+         * @brief Funzione che ritorna il pool del thread corrente, creato
+         * al primo utilizzo e distrutto all'uscita del thread. Dopo la sua
+         * distruzione ritorna std::pmr::new_delete_resource(), da cui
+         * provengono i blocchi del pool.
+         *
+         * @return std::pmr::memory_resource* risorsa del thread corrente
+         */
+        static std::pmr::memory_resource* local();
+};
+
+struct block_pool::local_holder{
+    block_pool pool; ///< pool del thread
+
+    ~local_holder(){
+        local_destroyed() = true;
+    }
+};
+
+inline std::pmr::memory_resource* block_pool::local(){
+    if(local_destroyed())
+        return std::pmr::new_delete_resource();
+    static thread_local local_holder holder;
+    return &holder.pool;
+}
+
+/**
+ * @brief Classe pool_allocator
+ *
+ * Allocatore compatibile con std::allocator che prende la memoria dal
+ * block_pool del thread corrente (block_pool::local()). Non ha stato e
+ * tutte le istanze sono uguali: un blocco allocato da un thread può
+ * essere liberato da un altro, e finisce nel pool di quest'ultimo.
+ *
+ * Esempio: cbuffer<int, modulo_index, overwrite_on_full, pool_allocator<int>>
+ *
+ * @tparam T tipo degli elementi allocati
+ */
+template<typename T> class pool_allocator{
+    public:
+        typedef T value_type;
+
+        pool_allocator() noexcept{}
+
+        /**
+         * @brief Costruttore di conversione da un pool_allocator di altro tipo
+         */
+        template<typename U> pool_allocator(const pool_allocator<U> &) noexcept{}
+
+        /**
+         * @brief Funzione che alloca memoria non inizializzata per n elementi
+         *
+         * @param n numero di elementi
+         * @return T* area allocata
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita
+         */
+        T* allocate(std::size_t n){
+            return static_cast<T*>(block_pool::local()->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * @brief Funzione che libera l'area p di n elementi
+         *
+         * @param p area allocata con allocate
+         * @param n numero di elementi passato ad allocate
+         */
+        void deallocate(T *p, std::size_t n) noexcept{
+            block_pool::local()->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        template<typename U> bool operator==(const pool_allocator<U> &) const noexcept{
+            return true;
+        }
+
+        template<typename U> bool operator!=(const pool_allocator<U> &) const noexcept{
+            return false;
+        }
+};
+
+#endif
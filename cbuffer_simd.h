@@ -0,0 +1,373 @@
+#ifndef CBUFFER_SIMD_H
+#define CBUFFER_SIMD_H
+#include <algorithm>
+#include <cstddef> // std::size_t
+#include <stdexcept> // std::invalid_argument
+#include <type_traits> // std::is_same
+#include "cbuffer.h"
+#include "empty_queue_exception.h"
+/**
+ * @file cbuffer_simd.h
+ * @brief Riduzioni vettorizzate (somma, minimo, massimo, media,
+ * prodotto scalare) per cbuffer<float> e cbuffer<double>
+ *
+ * Le riduzioni lavorano direttamente sui segmenti contigui della coda.
+ * Su x86 con GCC/Clang sono disponibili kernel SSE2 e AVX2, compilati
+ * con l'attributo target (non serve -mavx2) e scelti a run time in base
+ * alla CPU; altrimenti si usa il kernel scalare. Somma, media e prodotto
+ * scalare usano più accumulatori in parallelo, quindi il risultato può
+ * differire da una somma sequenziale per l'arrotondamento. In presenza
+ * di NaN il risultato di minimo e massimo non è specificato.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CBUFFER_SIMD_X86
+#include <immintrin.h>
+#define CBUFFER_TARGET_SSE2 __attribute__((target("sse2")))
+#define CBUFFER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/**
+ * @brief Livello di istruzioni vettoriali usato dalle riduzioni
+ */
+enum simd_level{
+    simd_scalar = 0, ///< kernel scalare, disponibile ovunque
+    simd_sse2 = 1, ///< vettori a 128 bit
+    simd_avx2 = 2 ///< vettori a 256 bit
+};
+
+/**
+ * @brief Funzione che ritorna il livello più alto supportato dalla CPU
+ * (rilevato una sola volta)
+ *
+ * @return simd_level livello supportato
+ */
+inline simd_level simd_supported(){
+#ifdef CBUFFER_SIMD_X86
+    static const simd_level level = __builtin_cpu_supports("avx2") ? simd_avx2
+        : __builtin_cpu_supports("sse2") ? simd_sse2 : simd_scalar;
+    return level;
+#else
+    return simd_scalar;
+#endif
+}
+
+/**
+ * @brief Funzione di supporto che ritorna il livello in uso
+ *
+ * @return simd_level& riferimento al livello in uso
+ */
+inline simd_level& simd_current(){
+    static simd_level level = simd_supported();
+    return level;
+}
+
+/**
+ * @brief Funzione che imposta il livello usato dalle riduzioni
+ * (per confronti e benchmark). Un livello non supportato dalla CPU
+ * viene ridotto a quello supportato.
+ *
+ * @param level livello richiesto
+ * @return simd_level livello effettivamente impostato
+ */
+inline simd_level simd_set_level(simd_level level){
+    simd_current() = std::min(level, simd_supported());
+    return simd_current();
+}
+
+/**
+ * @brief Kernel scalari: riferimento e fallback
+ */
+template<typename T> struct scalar_kernels{
+    static T sum(const T *p, std::size_t n){
+        T s = 0;
+        for(std::size_t i = 0; i < n; ++i)
+            s += p[i];
+        return s;
+    }
+    static T min(const T *p, std::size_t n){
+        T m = p[0];
+        for(std::size_t i = 1; i < n; ++i)
+            m = p[i] < m ? p[i] : m;
+        return m;
+    }
+    static T max(const T *p, std::size_t n){
+        T m = p[0];
+        for(std::size_t i = 1; i < n; ++i)
+            m = p[i] > m ? p[i] : m;
+        return m;
+    }
+    static T dot(const T *a, const T *b, std::size_t n){
+        T s = 0;
+        for(std::size_t i = 0; i < n; ++i)
+            s += a[i] * b[i];
+        return s;
+    }
+};
+
+#ifdef CBUFFER_SIMD_X86
+/**
+ * @brief Operazioni vettoriali per livello e tipo. Ogni specializzazione
+ * definisce il tipo vettore, il numero di elementi (width) e le
+ * operazioni elementari usate dai kernel.
+ */
+template<typename T> struct sse2_vec;
+template<typename T> struct avx2_vec;
+
+template<> struct sse2_vec<double>{
+    typedef __m128d vec;
+    static const std::size_t width = 2;
+    CBUFFER_TARGET_SSE2 static vec zero(){ return _mm_setzero_pd(); }
+    CBUFFER_TARGET_SSE2 static vec load(const double *p){ return _mm_loadu_pd(p); }
+    CBUFFER_TARGET_SSE2 static vec add(vec a, vec b){ return _mm_add_pd(a, b); }
+    CBUFFER_TARGET_SSE2 static vec mul(vec a, vec b){ return _mm_mul_pd(a, b); }
+    CBUFFER_TARGET_SSE2 static vec min(vec a, vec b){ return _mm_min_pd(a, b); }
+    CBUFFER_TARGET_SSE2 static vec max(vec a, vec b){ return _mm_max_pd(a, b); }
+    CBUFFER_TARGET_SSE2 static void store(double *p, vec a){ _mm_storeu_pd(p, a); }
+};
+
+template<> struct sse2_vec<float>{
+    typedef __m128 vec;
+    static const std::size_t width = 4;
+    CBUFFER_TARGET_SSE2 static vec zero(){ return _mm_setzero_ps(); }
+    CBUFFER_TARGET_SSE2 static vec load(const float *p){ return _mm_loadu_ps(p); }
+    CBUFFER_TARGET_SSE2 static vec add(vec a, vec b){ return _mm_add_ps(a, b); }
+    CBUFFER_TARGET_SSE2 static vec mul(vec a, vec b){ return _mm_mul_ps(a, b); }
+    CBUFFER_TARGET_SSE2 static vec min(vec a, vec b){ return _mm_min_ps(a, b); }
+    CBUFFER_TARGET_SSE2 static vec max(vec a, vec b){ return _mm_max_ps(a, b); }
+    CBUFFER_TARGET_SSE2 static void store(float *p, vec a){ _mm_storeu_ps(p, a); }
+};
+
+template<> struct avx2_vec<double>{
+    typedef __m256d vec;
+    static const std::size_t width = 4;
+    CBUFFER_TARGET_AVX2 static vec zero(){ return _mm256_setzero_pd(); }
+    CBUFFER_TARGET_AVX2 static vec load(const double *p){ return _mm256_loadu_pd(p); }
+    CBUFFER_TARGET_AVX2 static vec add(vec a, vec b){ return _mm256_add_pd(a, b); }
+    CBUFFER_TARGET_AVX2 static vec mul(vec a, vec b){ return _mm256_mul_pd(a, b); }
+    CBUFFER_TARGET_AVX2 static vec min(vec a, vec b){ return _mm256_min_pd(a, b); }
+    CBUFFER_TARGET_AVX2 static vec max(vec a, vec b){ return _mm256_max_pd(a, b); }
+    CBUFFER_TARGET_AVX2 static void store(double *p, vec a){ _mm256_storeu_pd(p, a); }
+};
+
+template<> struct avx2_vec<float>{
+    typedef __m256 vec;
+    static const std::size_t width = 8;
+    CBUFFER_TARGET_AVX2 static vec zero(){ return _mm256_setzero_ps(); }
+    CBUFFER_TARGET_AVX2 static vec load(const float *p){ return _mm256_loadu_ps(p); }
+    CBUFFER_TARGET_AVX2 static vec add(vec a, vec b){ return _mm256_add_ps(a, b); }
+    CBUFFER_TARGET_AVX2 static vec mul(vec a, vec b){ return _mm256_mul_ps(a, b); }
+    CBUFFER_TARGET_AVX2 static vec min(vec a, vec b){ return _mm256_min_ps(a, b); }
+    CBUFFER_TARGET_AVX2 static vec max(vec a, vec b){ return _mm256_max_ps(a, b); }
+    CBUFFER_TARGET_AVX2 static void store(float *p, vec a){ _mm256_storeu_ps(p, a); }
+};
+
+/**
+ * @brief Definisce i kernel vettoriali di un livello. I kernel sono
+ * identici per SSE2 e AVX2 a parte l'attributo target (che non può
+ * dipendere da un parametro template) e le operazioni V.
+ * Somma e prodotto scalare usano quattro accumulatori per nascondere
+ * la latenza dell'addizione; il resto (< width elementi) è scalare.
+ */
+#define CBUFFER_SIMD_KERNELS(NAME, TARGET)                                      \
+template<typename T, typename V> struct NAME{                                  \
+    TARGET static T reduce(typename V::vec a, T (*op)(T, T)){                  \
+        T lanes[V::width];                                                     \
+        V::store(lanes, a);                                                    \
+        T r = lanes[0];                                                        \
+        for(std::size_t i = 1; i < V::width; ++i)                              \
+            r = op(r, lanes[i]);                                               \
+        return r;                                                              \
+    }                                                                          \
+    static T plus(T a, T b){ return a + b; }                                   \
+    static T smaller(T a, T b){ return b < a ? b : a; }                        \
+    static T larger(T a, T b){ return b > a ? b : a; }                         \
+    TARGET static T sum(const T *p, std::size_t n){                            \
+        const std::size_t w = V::width;                                        \
+        typename V::vec a0 = V::zero(), a1 = a0, a2 = a0, a3 = a0;             \
+        std::size_t i = 0;                                                     \
+        for(; i + 4 * w <= n; i += 4 * w){                                     \
+            a0 = V::add(a0, V::load(p + i));                                   \
+            a1 = V::add(a1, V::load(p + i + w));                               \
+            a2 = V::add(a2, V::load(p + i + 2 * w));                           \
+            a3 = V::add(a3, V::load(p + i + 3 * w));                           \
+        }                                                                      \
+        for(; i + w <= n; i += w)                                              \
+            a0 = V::add(a0, V::load(p + i));                                   \
+        T s = reduce(V::add(V::add(a0, a1), V::add(a2, a3)), plus);            \
+        for(; i < n; ++i)                                                      \
+            s += p[i];                                                         \
+        return s;                                                              \
+    }                                                                          \
+    TARGET static T min(const T *p, std::size_t n){                            \
+        const std::size_t w = V::width;                                        \
+        if(n < w)                                                              \
+            return scalar_kernels<T>::min(p, n);                               \
+        typename V::vec m = V::load(p);                                        \
+        std::size_t i = w;                                                     \
+        for(; i + w <= n; i += w)                                              \
+            m = V::min(m, V::load(p + i));                                     \
+        m = V::min(m, V::load(p + n - w)); /* ultimi elementi (sovrapposti) */ \
+        return reduce(m, smaller);                                             \
+    }                                                                          \
+    TARGET static T max(const T *p, std::size_t n){                            \
+        const std::size_t w = V::width;                                        \
+        if(n < w)                                                              \
+            return scalar_kernels<T>::max(p, n);                               \
+        typename V::vec m = V::load(p);                                        \
+        std::size_t i = w;                                                     \
+        for(; i + w <= n; i += w)                                              \
+            m = V::max(m, V::load(p + i));                                     \
+        m = V::max(m, V::load(p + n - w));                                     \
+        return reduce(m, larger);                                              \
+    }                                                                          \
+    TARGET static T dot(const T *a, const T *b, std::size_t n){                \
+        const std::size_t w = V::width;                                        \
+        typename V::vec a0 = V::zero(), a1 = a0, a2 = a0, a3 = a0;             \
+        std::size_t i = 0;                                                     \
+        for(; i + 4 * w <= n; i += 4 * w){                                     \
+            a0 = V::add(a0, V::mul(V::load(a + i), V::load(b + i)));           \
+            a1 = V::add(a1, V::mul(V::load(a + i + w), V::load(b + i + w)));   \
+            a2 = V::add(a2, V::mul(V::load(a + i + 2 * w), V::load(b + i + 2 * w))); \
+            a3 = V::add(a3, V::mul(V::load(a + i + 3 * w), V::load(b + i + 3 * w))); \
+        }                                                                      \
+        for(; i + w <= n; i += w)                                              \
+            a0 = V::add(a0, V::mul(V::load(a + i), V::load(b + i)));           \
+        T s = reduce(V::add(V::add(a0, a1), V::add(a2, a3)), plus);            \
+        for(; i < n; ++i)                                                      \
+            s += a[i] * b[i];                                                  \
+        return s;                                                              \
+    }                                                                          \
+};
+
+CBUFFER_SIMD_KERNELS(sse2_kernels, CBUFFER_TARGET_SSE2)
+CBUFFER_SIMD_KERNELS(avx2_kernels, CBUFFER_TARGET_AVX2)
+#undef CBUFFER_SIMD_KERNELS
+#endif
+
+/**
+ * @brief Funzione di supporto che sceglie il kernel del livello in uso
+ * e lo chiama con gli argomenti passati
+ *
+ * @tparam T float o double
+ * @tparam Call tipo della funzione, invocabile come call(kernels) con
+ * kernels una delle classi scalar_kernels<T>, sse2_kernels, avx2_kernels
+ * @param call funzione da chiamare
+ * @return T risultato del kernel
+ */
+template<typename T, typename Call> T simd_dispatch(Call call){
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+        "SIMD reductions are available only for cbuffer<float> and cbuffer<double>");
+#ifdef CBUFFER_SIMD_X86
+    switch(simd_current()){
+        case simd_avx2:
+            return call(avx2_kernels<T, avx2_vec<T> >());
+        case simd_sse2:
+            return call(sse2_kernels<T, sse2_vec<T> >());
+        default:
+            break;
+    }
+#endif
+    return call(scalar_kernels<T>());
+}
+
+/**
+ * @brief Funzione che ritorna la somma degli elementi della coda
+ *
+ * @param b cbuffer di float o double
+ * @return T somma degli elementi (0 se la coda è vuota)
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator> T simd_sum(const cbuffer<T, Index, Overflow, Allocator> &b){
+    typename cbuffer<T, Index, Overflow, Allocator>::const_array_range one = b.array_one(), two = b.array_two();
+    return simd_dispatch<T>([&](auto kernels){
+        return kernels.sum(one.first, one.second) + kernels.sum(two.first, two.second);
+    });
+}
+
+/**
+ * @brief Funzione che ritorna il minimo degli elementi della coda
+ *
+ * @param b cbuffer di float o double
+ * @return T elemento minimo
+ * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator> T simd_min(const cbuffer<T, Index, Overflow, Allocator> &b){
+    if(b.is_empty())
+        throw empty_queue_exception("Cannot compute the minimum of an empty queue");
+    typename cbuffer<T, Index, Overflow, Allocator>::const_array_range one = b.array_one(), two = b.array_two();
+    return simd_dispatch<T>([&](auto kernels){
+        T m = kernels.min(one.first, one.second);
+        return two.second > 0 ? std::min(m, kernels.min(two.first, two.second)) : m;
+    });
+}
+
+/**
+ * @brief Funzione che ritorna il massimo degli elementi della coda
+ *
+ * @param b cbuffer di float o double
+ * @return T elemento massimo
+ * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator> T simd_max(const cbuffer<T, Index, Overflow, Allocator> &b){
+    if(b.is_empty())
+        throw empty_queue_exception("Cannot compute the maximum of an empty queue");
+    typename cbuffer<T, Index, Overflow, Allocator>::const_array_range one = b.array_one(), two = b.array_two();
+    return simd_dispatch<T>([&](auto kernels){
+        T m = kernels.max(one.first, one.second);
+        return two.second > 0 ? std::max(m, kernels.max(two.first, two.second)) : m;
+    });
+}
+
+/**
+ * @brief Funzione che ritorna la media degli elementi della coda
+ *
+ * @param b cbuffer di float o double
+ * @return T media degli elementi
+ * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+ */
+template<typename T, typename Index, typename Overflow, typename Allocator> T simd_mean(const cbuffer<T, Index, Overflow, Allocator> &b){
+    if(b.is_empty())
+        throw empty_queue_exception("Cannot compute the mean of an empty queue");
+    return simd_sum(b) / static_cast<T>(b.stored_elements());
+}
+
+/**
+ * @brief Funzione che ritorna il prodotto scalare tra le due code,
+ * elemento per elemento in ordine FIFO. I segmenti delle due code
+ * possono avere confini diversi: il calcolo avviene su al più tre
+ * tratti contigui in entrambe.
+ *
+ * @param a primo cbuffer
+ * @param b secondo cbuffer
+ * @return T somma di a[i] * b[i]
+ * @throw std::invalid_argument eccezione lanciata se le code hanno un numero diverso di elementi
+ */
+template<typename T, typename IndexA, typename OverflowA, typename AllocatorA, typename IndexB, typename OverflowB, typename AllocatorB>
+T simd_dot(const cbuffer<T, IndexA, OverflowA, AllocatorA> &a, const cbuffer<T, IndexB, OverflowB, AllocatorB> &b){
+    if(a.stored_elements() != b.stored_elements())
+        throw std::invalid_argument("Cannot compute the dot product of queues with a different number of elements");
+    typename cbuffer<T, IndexA, OverflowA, AllocatorA>::const_array_range a_seg[2] = {a.array_one(), a.array_two()};
+    typename cbuffer<T, IndexB, OverflowB, AllocatorB>::const_array_range b_seg[2] = {b.array_one(), b.array_two()};
+    return simd_dispatch<T>([&](auto kernels){
+        T s = 0;
+        unsigned int i = 0, j = 0, a_done = 0, b_done = 0; // segmento corrente e elementi già usati
+        while(i < 2 && j < 2){
+            unsigned int n = std::min(a_seg[i].second - a_done, b_seg[j].second - b_done);
+            if(n > 0)
+                s += kernels.dot(a_seg[i].first + a_done, b_seg[j].first + b_done, n);
+            a_done += n;
+            b_done += n;
+            if(a_done == a_seg[i].second){
+                ++i;
+                a_done = 0;
+            }
+            if(b_done == b_seg[j].second){
+                ++j;
+                b_done = 0;
+            }
+        }
+        return s;
+    });
+}
+
+#endif
@@ -0,0 +1,8 @@
+#include "invalid_file_exception.h"
+
+invalid_file_exception::invalid_file_exception(const std::string &message) 
+    : std::runtime_error(message) {}
+
+
+
+
@@ -0,0 +1,24 @@
+#ifndef INVALID_FILE_EXCEPTION_H
+#define INVALID_FILE_EXCEPTION_H
+#include <stdexcept>
+/**
+ * @brief Classe Eccezione
+ * 
+ * La classe implementa un'eccezione a run time in
+ * caso di file con intestazione assente, danneggiata
+ * o incompatibile con il tipo degli elementi
+ * 
+ */
+class invalid_file_exception : public std::runtime_error {
+	
+	public:
+		/**
+		 * @brief Costruttore 
+		 * 
+		 * @param message stringa contenente il messaggio
+		 */
+		invalid_file_exception(const std::string &message);
+
+};
+
+#endif
\ No newline at end of file
@@ -1,73 +1,76 @@
 #include "cbuffer.h"
+#include "spsc_cbuffer.h"
+#include "mpmc_cbuffer.h"
+#include "cbuffer_algorithm.h"
+#include "cbuffer_simd.h"
+#include "window_cbuffer.h"
+#include "quantile_cbuffer.h"
+#include "mapped_cbuffer.h"
+#include "shm_spsc_cbuffer.h"
+#include "mirrored_cbuffer.h"
+#include "record_cbuffer.h"
+#include "cbuffer_pool.h"
+#include "static_cbuffer.h"
+#include "small_cbuffer.h"
+#include "person.h"
 #include <iostream>
 #include <cassert>
 #include <string>
+#include <memory>
+#include <sstream>
+#include <iterator>
+#include <vector>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <memory_resource>
+#include <cmath>
+#include <cstdio>
+#include <csignal>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
 /**
- * @brief Struct person che rappresenta una persona.
- * 
- *  Struct person che rappresenta una persona.
+ * @brief Struct senza costruttore di default che conta le
+ * istanze vive, usata per verificare la costruzione lazy
+ * degli slot del cbuffer.
  */
-struct person{
-    std::string name;///<  nome della persona
-    std::string surname;///< cognome della persona
+struct counted{
+    static int alive;///< numero di istanze vive
+    int value;///< valore
 
-    /**
-    * @brief Costruttore di default
-    */
-    person(): name(""), surname(""){}
     /**
      * @brief Costruttore secondario
      * 
-     * @param name nome della persona
-     * @param surname cognome della persona
+     * @param v valore
      */
-    person(const std::string name, const std::string surname)
-        :name(name), surname(surname){}
-    
+    explicit counted(int v): value(v){ ++alive; }
     /**
-     * @brief Operatore assegnamento
-     * Necessario per la classe sparsematrix
+     * @brief Copy constructor
      * 
-     * @param other persona
-     * @return reference dell'oggetto persona this
+     * @param other oggetto da copiare
      */
-    person& operator=(const person &other){
-        name=other.name;
-        surname=other.surname;
-        return *this;
-    } 
-     /**
-     * @brief Ridefinizione dell'operatore di stream << per un point.
-     * Necessario per l'operatore di stream della classe sparsematrix.
-     * 
-     * */
-    friend std::ostream& operator<<(std::ostream &os, const person &p){
-        return os<<"["<<p.name<<","<<p.surname<<"]"; 
-    }
+    counted(const counted &other): value(other.value){ ++alive; }
     /**
-     * @brief Ridefinizione dell'operatore assegnamento
+     * @brief Operatore assegnamento
      * 
-     * @param other reference di un oggetto persona
-     * @return true se i dati membri dell'oggetto this sono uguali a
-     * quelli dell'oggetto other
-     * @return false altrimenti
+     * @param other oggetto da copiare
+     * @return reference dell'oggetto this
      */
-    bool operator==(const person &other) const{
-      return name == other.name && surname == other.surname;
+    counted& operator=(const counted &other){
+        value = other.value;
+        return *this;
     }
-
     /**
-     * @brief Funzione che verifica se il nome della persona
-     * inizia con il carattere passato come parametro
-     * 
-     * @param c carattere iniziale
-     * @return true se il nome inizia con il carattere passato in input
-     * @return false altrimenti
+     * @brief Distruttore
      */
-    bool name_stars_with(const char &c) const{
-      return name.at(0) == c;
-    }
+    ~counted(){ --alive; }
 };
+int counted::alive = 0;
 
 /**
  * @brief Funzione che carica i dati nel cbuffer
@@ -227,10 +230,10 @@ void test_metodi_fondamentali_person(){
   assert(!a.is_full());
   assert(a.is_empty());
   for(unsigned int i = 0; i < c.size()-2; ++i)
-    c.enqueue(person("Mario"+1, "Rossi"+i));
+    c.enqueue(person("Mario"+std::to_string(1), "Rossi"+std::to_string(i)));
   assert(c.size() == 10 && c.stored_elements() == 8);
-  c.enqueue(person("Mario "+99, "Rossi "+99));
-  c.enqueue(person("Mario "+98, "Rossi "+98));
+  c.enqueue(person("Mario "+std::to_string(99), "Rossi "+std::to_string(99)));
+  c.enqueue(person("Mario "+std::to_string(98), "Rossi "+std::to_string(98)));
   assert(c.stored_elements() == 10);
   assert(c.is_full());
   assert(!c.is_empty());
@@ -591,14 +594,16 @@ void test_iterator_person(){
   j = queue.begin();
   k = queue.end();
   assert(j[0]==person("Giulio", "Cesare"));
-  assert(j[10]==person("Giulio", "Cesare"));
-  assert(j[-20]==person("Giulio", "Cesare"));
+  assert(j[4]==person("Lucio", "Vero"));
+  assert(k - j == 5 && std::distance(j, k) == 5);
   j++;
   assert(j[0]==person("Marco", "Aurelio"));
+  assert(j[-1]==person("Giulio", "Cesare"));
   j--;
   assert(j[0]==person("Giulio", "Cesare"));
-  j--;
-  assert(j[0]==person("Lucio", "Vero")); //coda
+  --k;
+  assert(*k==person("Lucio", "Vero")); //coda
+  assert(j < k && k > j && j <= j && k >= j);
 
   j = queue.begin();
   j = j + 1;
@@ -882,10 +887,9 @@ void test_const_iterator_person(const cbuffer<person> &c){
   
   }
   std::cout<<"]"<<std::endl;
-  //riparte da capo
-  assert(*j == c.head());
-  j++;
-  assert(*j == j[0]);
+  assert(j == k && j - c.begin() == c.stored_elements());
+  j = c.begin();
+  assert(*j == c.head() && *(k - 1) == c.tail());
 
 }
 
@@ -948,6 +952,1585 @@ void test_cbuffer_of_cbuffer(){
   
 }
 
+/**
+ * @brief Test sulla memoria non inizializzata: gli slot vengono
+ * costruiti con enqueue e distrutti con dequeue/clear/distruttore
+ *  
+ */
+void test_uninitialized_storage(){
+  {
+    cbuffer<counted> b(1000);
+    assert(counted::alive == 0); // nessuno slot costruito
+    for(int i = 0; i < 5; ++i)
+      b.enqueue(counted(i));
+    assert(counted::alive == 5);
+    counted x = b.dequeue();
+    assert(x.value == 0 && counted::alive == 5); // 4 nel buffer + x
+    const counted *array = b.array_one().first - 1;
+    b.clear();
+    assert(counted::alive == 1);
+    b.enqueue(counted(5));
+    assert(b.array_one().first == array); // clear non rialloca l'array
+
+    cbuffer<counted> w(4); // clear con gli elementi su due segmenti
+    for(int i = 0; i < 6; ++i)
+      w.enqueue(counted(i));
+    assert(w.array_two().second == 2 && counted::alive == 6);
+    w.clear();
+    assert(counted::alive == 2 && w.is_empty() && w.size() == 4);
+    w.clear();
+    b.clear();
+    assert(counted::alive == 1);
+    
+    cbuffer<counted> c(3);
+    for(int i = 0; i < 10; ++i) //sovrascrittura
+      c.enqueue(counted(i));
+    assert(counted::alive == 4);
+    assert(c.head().value == 7 && c.tail().value == 9);
+    cbuffer<counted> d(c);
+    assert(counted::alive == 7);
+    assert(d[0].value == 7 && d[2].value == 9);
+    try{
+      d[3];
+    }catch(const std::out_of_range &e){
+      std::cout<< e.what() <<std::endl;
+    }
+  }
+  assert(counted::alive == 0);
+}
+
+/**
+ * @brief Test su enqueue/emplace/pop con semantica di spostamento
+ * e su move constructor/assegnamento del cbuffer
+ *  
+ */
+void test_move_semantics(){
+  //tipo non copiabile: compila solo se non vengono fatte copie
+  cbuffer<std::unique_ptr<int>> p(3);
+  p.enqueue(std::unique_ptr<int>(new int(1)));
+  p.emplace(new int(2));
+  std::unique_ptr<int> three(new int(3));
+  p.enqueue(std::move(three));
+  assert(three == nullptr);
+  p.emplace(new int(4)); //coda piena: sovrascrive 1
+  assert(*p.head() == 2 && *p.tail() == 4);
+  std::unique_ptr<int> x = p.pop();
+  assert(*x == 2 && p.stored_elements() == 2);
+  
+  cbuffer<std::unique_ptr<int>> q(std::move(p));
+  assert(p.size() == 0 && p.is_empty());
+  assert(q.size() == 3 && *q.head() == 3);
+  p = std::move(q);
+  assert(q.size() == 0 && *p[1] == 4);
+
+  //lo spostamento lascia la stringa sorgente vuota
+  cbuffer<std::string> s(2);
+  std::string payload(100, 'x');
+  s.enqueue(std::move(payload));
+  assert(payload.empty() && s.head().size() == 100);
+  assert(s.emplace(3, 'y') == "yyy");
+  std::string y = s.pop();
+  assert(y.size() == 100 && s.head() == "yyy");
+
+  //cbuffer di cbuffer costruito in loco
+  cbuffer<cbuffer<double>> cb(2);
+  cb.emplace(4);
+  cb.head().enqueue(3.14);
+  cbuffer<double> moved = cb.pop();
+  assert(moved.size() == 4 && moved.head() == 3.14);
+}
+
+/**
+ * @brief Test sulla politica di indicizzazione a potenze di due
+ *  
+ */
+void test_pow2_index(){
+  cbuffer<int, pow2_index> b(10); //arrotondata a 16
+  assert(b.size() == 16);
+  cbuffer<int, pow2_index> empty(0);
+  assert(empty.size() == 0);
+  for(int i = 0; i < 100; ++i) //contatori monotoni con sovrascrittura
+    b.enqueue(i);
+  assert(b.is_full() && b.head() == 84 && b.tail() == 99);
+  for(unsigned int i = 0; i < b.stored_elements(); ++i)
+    assert(b[i] == static_cast<int>(84 + i));
+  for(int i = 0; i < 10; ++i)
+    assert(b.pop() == 84 + i);
+  assert(b.stored_elements() == 6 && b.head() == 94);
+  cbuffer<int, pow2_index> c(b);
+  assert(c.size() == 16 && c[5] == 99);
+  cbuffer<int, pow2_index>::const_iterator it, e;
+  it = c.begin();
+  e = c.end();
+  int expected = 94;
+  for(; it != e; ++it)
+    assert(*it == expected++);
+  assert(expected == 100);
+
+  double vettore[5] = {1.5, 2.5, 3.5, 4.5, 5.5};
+  cbuffer<int, pow2_index> d(3, vettore, vettore + 5); //arrotondata a 4
+  assert(d.size() == 4 && d.head() == 2 && d.tail() == 5);
+}
+
+/**
+ * @brief Test su enqueue_range e dequeue_into
+ *  
+ */
+void test_bulk_operations(){
+  std::vector<int> v;
+  for(int i = 0; i < 20; ++i)
+    v.push_back(i);
+
+  cbuffer<int> b(8);
+  b.enqueue(-1);
+  b.enqueue(-2);
+  b.pop(); //testa spostata: la scrittura si divide in due segmenti
+  b.enqueue_range(v.begin(), v.begin() + 5);
+  assert(b.stored_elements() == 6 && b.head() == -2 && b.tail() == 4);
+  b.enqueue_range(v.begin() + 5, v.begin() + 9); //sovrascrive i 2 più vecchi
+  assert(b.is_full() && b.head() == 1 && b.tail() == 8);
+  b.enqueue_range(v.begin(), v.end()); //restano gli ultimi 8
+  for(int i = 0; i < 8; ++i)
+    assert(b[i] == 12 + i);
+
+  int out[8];
+  assert(b.dequeue_into(out, 3) == 3);
+  assert(out[0] == 12 && out[2] == 14 && b.head() == 15);
+  assert(b.dequeue_into(out, 100) == 5);
+  assert(out[4] == 19 && b.is_empty());
+  assert(b.dequeue_into(out, 1) == 0);
+
+  //iteratori di input: elemento per elemento
+  std::istringstream is("1 2 3 4 5");
+  cbuffer<int, pow2_index> p(4);
+  p.enqueue_range(std::istream_iterator<int>(is), std::istream_iterator<int>());
+  assert(p.head() == 2 && p.tail() == 5);
+
+  //tipi non banali: costruzione e assegnamento
+  std::string words[6] = {"a", "b", "c", "d", "e", "f"};
+  cbuffer<std::string> s(4);
+  s.enqueue("z");
+  s.enqueue_range(words, words + 6);
+  assert(s.head() == "c" && s.tail() == "f");
+  std::vector<std::string> moved;
+  assert(s.dequeue_into(std::back_inserter(moved), 3) == 3);
+  assert(moved.size() == 3 && moved[0] == "c" && moved[2] == "e" && s.head() == "f");
+  cbuffer<std::string> copy(s);
+  assert(copy.stored_elements() == 1 && copy.head() == "f");
+
+  cbuffer<int> empty(0);
+  try{
+    empty.enqueue_range(v.begin(), v.end());
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Test su array_one, array_two e linearize
+ *  
+ */
+void test_array_ranges(){
+  cbuffer<int> b(6);
+  assert(b.array_one().second == 0 && b.array_two().second == 0);
+  for(int i = 0; i < 4; ++i)
+    b.enqueue(i);
+  assert(b.array_one().second == 4 && b.array_two().second == 0);
+  b.pop();
+  b.pop();
+  for(int i = 4; i < 8; ++i) //coda circolare: 2 3 4 5 | 6 7
+    b.enqueue(i);
+  cbuffer<int>::array_range one = b.array_one();
+  cbuffer<int>::array_range two = b.array_two();
+  assert(one.second == 4 && two.second == 2);
+  assert(*one.first == 2 && *two.first == 6);
+  int sum = std::accumulate(one.first, one.first + one.second, 0);
+  sum = std::accumulate(two.first, two.first + two.second, sum);
+  assert(sum == 2 + 3 + 4 + 5 + 6 + 7);
+
+  b.linearize();
+  assert(b.array_two().second == 0 && b.array_one().second == 6);
+  for(int i = 0; i < 6; ++i)
+    assert(b[i] == i + 2 && b.array_one().first[i] == i + 2);
+  b.enqueue(8);
+  assert(b.head() == 3 && b.tail() == 8);
+
+  //coda non piena e circolare con tipi non banali
+  cbuffer<std::string> s(5);
+  for(int i = 0; i < 5; ++i)
+    s.enqueue(std::to_string(i));
+  s.pop();
+  s.pop();
+  s.pop();
+  s.enqueue("5"); // 3 4 | 5
+  const cbuffer<std::string> &cs = s;
+  assert(cs.array_one().second == 2 && cs.array_two().second == 1);
+  cbuffer<std::string>::array_range all = s.linearize();
+  assert(all.first[0] == "3" && all.first[1] == "4" && all.first[2] == "5" && all.second == 3);
+  assert(s.head() == "3" && s.tail() == "5");
+  s.enqueue("6");
+  s.enqueue("7");
+  s.enqueue("8");
+  assert(s.head() == "4" && s.tail() == "8");
+}
+
+/**
+ * @brief Test su spsc_cbuffer: un produttore e un consumatore
+ * su thread diversi, verifica dell'ordine FIFO
+ *  
+ */
+void test_spsc_cbuffer(){
+  spsc_cbuffer<int> b(100);
+  assert(b.size() == 128 && b.is_empty());
+  int x = 0;
+  assert(!b.try_dequeue(x));
+  for(int i = 0; i < 128; ++i)
+    assert(b.try_enqueue(i));
+  assert(b.is_full() && !b.try_enqueue(128));
+  for(int i = 0; i < 128; ++i)
+    assert(b.try_dequeue(x) && x == i);
+  assert(b.is_empty());
+
+  const int n = 1000000;
+  spsc_cbuffer<std::string> s(64);
+  std::thread producer([&s](){
+    for(int i = 0; i < n; ++i)
+      while(!s.try_enqueue(std::to_string(i)))
+        std::this_thread::yield();
+  });
+  std::string value;
+  for(int i = 0; i < n; ++i){
+    while(!s.try_dequeue(value))
+      std::this_thread::yield();
+    assert(value == std::to_string(i));
+  }
+  producer.join();
+  assert(s.is_empty());
+
+  {
+    spsc_cbuffer<counted> c(4);
+    c.try_emplace(1);
+    c.try_emplace(2);
+    assert(counted::alive == 2);
+  }
+  assert(counted::alive == 0); //il distruttore distrugge gli elementi non letti
+  try{
+    spsc_cbuffer<int> negative(-1);
+  }catch(const negative_queue_size_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Stress test su mpmc_cbuffer: più produttori e più consumatori,
+ * verifica che ogni valore sia letto esattamente una volta
+ *  
+ */
+void test_mpmc_cbuffer(){
+  mpmc_cbuffer<int> b(3);
+  assert(b.size() == 4);
+  int x = 0;
+  assert(!b.try_dequeue(x));
+  for(int i = 0; i < 4; ++i)
+    assert(b.try_enqueue(i));
+  assert(!b.try_enqueue(4) && b.stored_elements() == 4);
+  for(int i = 0; i < 4; ++i)
+    assert(b.try_dequeue(x) && x == i);
+  mpmc_cbuffer<int> one(1);
+  assert(one.size() == 2);
+
+  const int producers = 4;
+  const int consumers = 4;
+  const int per_producer = 100000;
+  const int total = producers * per_producer;
+  mpmc_cbuffer<int> queue(64);
+  std::vector<std::atomic<int>> seen(total);
+  for(int i = 0; i < total; ++i)
+    seen[i] = 0;
+  std::atomic<int> consumed(0);
+  std::vector<std::thread> threads;
+  for(int p = 0; p < producers; ++p)
+    threads.push_back(std::thread([&queue, p](){
+      for(int i = 0; i < per_producer; ++i)
+        while(!queue.try_enqueue(p * per_producer + i))
+          std::this_thread::yield();
+    }));
+  for(int c = 0; c < consumers; ++c)
+    threads.push_back(std::thread([&](){
+      int value = 0;
+      while(consumed.load() < total){
+        if(queue.try_dequeue(value)){
+          seen[value]++;
+          consumed++;
+        }else
+          std::this_thread::yield();
+      }
+    }));
+  for(unsigned int i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  assert(consumed.load() == total && queue.is_empty());
+  for(int i = 0; i < total; ++i)
+    assert(seen[i] == 1); //nessuna perdita, nessun duplicato
+
+  {
+    mpmc_cbuffer<counted> c(8);
+    c.try_emplace(1);
+    c.try_emplace(2);
+    counted out(0);
+    assert(c.try_dequeue(out) && out.value == 1);
+    assert(counted::alive == 2);
+  }
+  assert(counted::alive == 0);
+}
+
+/**
+ * @brief Test sull'API try_* che non lancia eccezioni
+ *  
+ */
+void test_try_api(){
+  cbuffer<int> empty(0);
+  assert(!empty.try_enqueue(1));
+  int x = 42;
+  assert(!empty.try_dequeue(x) && x == 42);
+  assert(empty.try_front() == nullptr && empty.try_back() == nullptr);
+  assert(!empty.try_pop());
+
+  cbuffer<std::string> b(3);
+  const cbuffer<std::string> &cb = b;
+  assert(cb.try_front() == nullptr);
+  std::string s("first");
+  assert(b.try_enqueue(std::move(s)) && s.empty());
+  assert(b.try_enqueue(std::string("second")));
+  assert(*b.try_front() == "first" && *cb.try_back() == "second");
+  *b.try_back() = "changed";
+  assert(b.tail() == "changed");
+  std::string out;
+  assert(b.try_dequeue(out) && out == "first");
+  std::optional<std::string> o = b.try_pop();
+  assert(o && *o == "changed");
+  assert(!b.try_pop() && !b.try_dequeue(out) && out == "first");
+  //l'API con eccezioni resta disponibile
+  try{
+    b.pop();
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  static_assert(noexcept(std::declval<cbuffer<int>&>().try_dequeue(x)), "try_dequeue deve essere noexcept");
+  static_assert(noexcept(std::declval<cbuffer<int>&>().try_front()), "try_front deve essere noexcept");
+}
+
+/**
+ * @brief Test delle politiche di inserimento su coda piena:
+ * reject_on_full su cbuffer e block_on_full sulle code concorrenti
+ *  
+ */
+void test_overflow_policy(){
+  cbuffer<int, modulo_index, reject_on_full> r(3);
+  assert(r.enqueue(1) && r.enqueue(2) && r.enqueue(3));
+  assert(!r.enqueue(4) && !r.try_enqueue(5) && !r.try_emplace(6));
+  assert(r.head() == 1 && r.tail() == 3); //nessun elemento sovrascritto
+  r.pop();
+  std::vector<int> v{10, 20, 30};
+  assert(r.enqueue_range(v.begin(), v.end()) == 1);
+  assert(r[0] == 2 && r[1] == 3 && r[2] == 10);
+
+  cbuffer<int> o(3); //default: overwrite_on_full
+  assert(o.enqueue_range(v.begin(), v.end()) == 3 && o.enqueue(40));
+  assert(o.try_emplace(50) && o.head() == 30 && o.tail() == 50);
+
+  const int n = 100000;
+  spsc_cbuffer<int, block_on_full> s(4);
+  std::thread consumer([&s](){
+    int x = 0;
+    for(int i = 0; i < n; ++i){
+      while(!s.try_dequeue(x))
+        std::this_thread::yield();
+      assert(x == i);
+    }
+  });
+  for(int i = 0; i < n; ++i)
+    assert(s.enqueue(i)); //attende quando la coda è piena
+  consumer.join();
+  assert(s.is_empty());
+
+  mpmc_cbuffer<int, block_on_full> m(2);
+  std::atomic<long long> sum(0);
+  std::thread slow([&m, &sum](){
+    int x = 0;
+    for(int i = 0; i < 2 * n; ++i){
+      while(!m.try_dequeue(x))
+        std::this_thread::yield();
+      sum += x;
+    }
+  });
+  std::thread p1([&m](){ for(int i = 0; i < n; ++i) m.enqueue(1); });
+  std::thread p2([&m](){ for(int i = 0; i < n; ++i) m.emplace(2); });
+  p1.join();
+  p2.join();
+  slow.join();
+  assert(sum == 3LL * n && m.is_empty());
+
+  spsc_cbuffer<int> rejecting(1);
+  assert(rejecting.enqueue(1) && !rejecting.enqueue(2));
+}
+
+/**
+ * @brief Test degli iteratori ad accesso casuale su una coda
+ * circolare (testa spostata): algoritmi della STL e aritmetica
+ *  
+ */
+void test_random_access_iterator(){
+  typedef cbuffer<int>::iterator iterator;
+  static_assert(std::is_same<std::iterator_traits<iterator>::iterator_category,
+    std::random_access_iterator_tag>::value, "iterator deve essere random access");
+  static_assert(std::is_same<std::iterator_traits<cbuffer<int>::const_iterator>::iterator_category,
+    std::random_access_iterator_tag>::value, "const_iterator deve essere random access");
+
+  cbuffer<int> b(7);
+  int values[] = {5, 3, 9, 1, 7, 2, 8, 6, 4};
+  for(int v : values)
+    b.enqueue(v); //la coda fa il giro: [9 1 7 2 8 6 4]
+  assert(b.array_two().second > 0);
+  assert(std::distance(b.begin(), b.end()) == 7 && b.end() - b.begin() == 7);
+
+  iterator it = b.begin();
+  assert(*(it + 3) == 2 && *(3 + it) == 2 && it[6] == 4);
+  it += 6;
+  assert(*it == 4 && *(it - 6) == 9 && it - b.begin() == 6);
+  it -= 2;
+  assert(*it == 8 && it > b.begin() && it < b.end());
+
+  std::sort(b.begin(), b.end());
+  for(unsigned int i = 1; i < b.stored_elements(); ++i)
+    assert(b[i - 1] <= b[i]);
+  assert(b.head() == 1 && b.tail() == 9);
+  const cbuffer<int> &cb = b;
+  assert(*std::lower_bound(cb.begin(), cb.end(), 5) == 6);
+  assert(std::binary_search(cb.begin(), cb.end(), 7));
+  assert(std::upper_bound(cb.begin(), cb.end(), 9) == cb.end());
+
+  std::reverse(b.begin(), b.end());
+  assert(b.head() == 9 && b.tail() == 1);
+  assert(std::accumulate(cb.begin(), cb.end(), 0) == 37);
+
+  cbuffer<int, pow2_index> p(4);
+  for(int i = 0; i < 6; ++i)
+    p.enqueue(i); //[2 3 4 5]
+  std::vector<int> copy(p.begin(), p.end());
+  assert((copy == std::vector<int>{2, 3, 4, 5}));
+  cbuffer<int, pow2_index>::const_iterator c = p.end();
+  assert(*--c == 5 && c[-3] == 2);
+
+  cbuffer<int> empty(0);
+  assert(empty.begin() == empty.end());
+}
+
+/**
+ * @brief Test degli algoritmi segmentati: stessi risultati degli
+ * algoritmi della STL sugli iteratori, anche a coda circolare
+ *  
+ */
+void test_segmented_algorithms(){
+  cbuffer<double> b(1000);
+  for(int i = 0; i < 1600; ++i)
+    b.enqueue(i * 0.25); //due segmenti: 600 + 400 elementi
+  assert(b.array_one().second == 400 && b.array_two().second == 600);
+  const cbuffer<double> &cb = b;
+
+  int segments = 0;
+  unsigned int visited = 0;
+  cb.for_each_segment([&](const double *first, const double *last){ ++segments; visited += last - first; });
+  assert(segments == 2 && visited == b.stored_elements());
+
+  assert(accumulate(cb, 0.0) == std::accumulate(cb.begin(), cb.end(), 0.0));
+  assert(accumulate(cb, 1.0, [](double a, double x){ return a * 0.5 + x; }) ==
+    std::accumulate(cb.begin(), cb.end(), 1.0, [](double a, double x){ return a * 0.5 + x; }));
+
+  assert(find(b, 200.0) == std::find(b.begin(), b.end(), 200.0) && *find(b, 200.0) == 200.0); //primo segmento
+  assert(find(cb, 300.0) - cb.begin() == 1200 - 600); //secondo segmento
+  assert(find(b, 1.0) == b.end() && find_if(cb, [](double x){ return x > 1000; }) == cb.end());
+  assert(count_if(cb, [](double x){ return x >= 250; }) == std::count_if(cb.begin(), cb.end(), [](double x){ return x >= 250; }));
+  assert(count(cb, 150.0) == 1);
+
+  std::vector<double> doubled(b.stored_elements());
+  assert(transform(cb, doubled.begin(), [](double x){ return 2 * x; }) == doubled.end());
+  for(unsigned int i = 0; i < b.stored_elements(); ++i)
+    assert(doubled[i] == 2 * b[i]);
+
+  for_each(b, [](double &x){ x = -x; });
+  assert(b.head() == -150.0 && b.tail() == -399.75);
+  unsigned int n = 0;
+  for_each(cb, [&n](const double &){ ++n; });
+  assert(n == 1000);
+
+  cbuffer<std::string> s(3);
+  assert(accumulate(s, std::string("vuoto")) == "vuoto" && find(s, "C++") == s.end());
+  load_data(s); //[PHP Go lang SQL]
+  assert(accumulate(s, std::string()) == "PHPGo langSQL");
+  assert(find(s, "Go lang") == s.begin() + 1);
+}
+
+/**
+ * @brief Funzione di supporto che verifica le riduzioni vettorizzate
+ * su una coda circolare di n elementi contro i cicli semplici
+ * 
+ * @param n numero di elementi
+ * @param shift elementi inseriti in più per spostare la testa
+ */
+template<typename T> void check_simd_reductions(unsigned int n, unsigned int shift){
+  cbuffer<T> a(n), b(n);
+  for(unsigned int i = 0; i < n + shift; ++i){
+    a.enqueue(static_cast<T>(static_cast<int>((i * 37) % 101) - 50) / 8);
+    b.enqueue(static_cast<T>(static_cast<int>((i * 11) % 23) - 7) / 4);
+  }
+  for(unsigned int i = 0; i < 2; ++i) //b ha la testa in un'altra posizione
+    b.enqueue(b.head());
+  double sum = 0, dot = 0;
+  T lo = a[0], hi = a[0];
+  for(unsigned int i = 0; i < a.stored_elements(); ++i){
+    sum += a[i];
+    dot += static_cast<double>(a[i]) * b[i];
+    lo = std::min(lo, a[i]);
+    hi = std::max(hi, a[i]);
+  }
+  double tolerance = 1e-3 * (1 + n);
+  assert(std::abs(simd_sum(a) - sum) <= tolerance);
+  assert(std::abs(simd_mean(a) - sum / n) <= tolerance / n);
+  assert(std::abs(simd_dot(a, b) - dot) <= tolerance);
+  assert(simd_min(a) == lo && simd_max(a) == hi);
+}
+
+/**
+ * @brief Test delle riduzioni vettorizzate con tutti i livelli
+ * supportati dalla CPU (scalare, SSE2, AVX2)
+ *  
+ */
+void test_simd_reductions(){
+  unsigned int sizes[] = {1, 3, 7, 8, 17, 64, 100, 1001};
+  for(int level = simd_scalar; level <= simd_supported(); ++level){
+    assert(simd_set_level(static_cast<simd_level>(level)) == level);
+    for(unsigned int n : sizes){
+      check_simd_reductions<double>(n, n / 3);
+      check_simd_reductions<float>(n, n / 2 + 1);
+    }
+  }
+  simd_set_level(simd_avx2);
+  assert(simd_current() == simd_supported());
+
+  cbuffer<double> empty(4), other(4);
+  assert(simd_sum(empty) == 0);
+  try{
+    simd_min(empty);
+    assert(false);
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  other.enqueue(1.0);
+  try{
+    simd_dot(empty, other);
+    assert(false);
+  }catch(const std::invalid_argument &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Test di pop_tail e della finestra scorrevole con statistiche
+ * incrementali, confrontate con il ricalcolo sui valori della finestra
+ *  
+ */
+void test_window_cbuffer(){
+  cbuffer<int> d(3);
+  d.enqueue(1); d.enqueue(2); d.enqueue(3); d.enqueue(4); //[2 3 4]
+  assert(d.pop_tail() == 4 && d.tail() == 3 && d.head() == 2);
+  d.enqueue(5);
+  assert(d.pop() == 2 && d.pop_tail() == 5 && d.pop_tail() == 3 && d.is_empty());
+  try{
+    d.pop_tail();
+    assert(false);
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+
+  unsigned int sizes[] = {1, 2, 7, 64};
+  for(unsigned int size : sizes){
+    window_cbuffer<int> w(size);
+    unsigned int seed = 12345;
+    for(int i = 0; i < 1000; ++i){
+      seed = seed * 1103515245u + 12345u;
+      w.enqueue(static_cast<int>((seed >> 16) % 201) - 100);
+      if(i % 97 == 0)
+        w.pop(); //la finestra può anche restringersi
+      if(w.is_empty())
+        continue;
+      const cbuffer<int> &values = w.window();
+      long long sum = 0, squares = 0;
+      int lo = values.head(), hi = values.head();
+      for(int v : values){
+        sum += v;
+        squares += static_cast<long long>(v) * v;
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+      }
+      double n = values.stored_elements(), mean = sum / n;
+      assert(w.sum() == sum && w.sum_of_squares() == squares);
+      assert(w.min() == lo && w.max() == hi);
+      assert(std::abs(w.mean() - mean) < 1e-9);
+      assert(std::abs(w.variance() - (squares / n - mean * mean)) < 1e-6);
+    }
+  }
+
+  //con pow2_index la capacità viene arrotondata a 8, la finestra resta di 5 valori
+  window_cbuffer<int, pow2_index> p(5);
+  for(int i = 1; i <= 7; ++i)
+    p.enqueue(i); //[3 4 5 6 7]
+  assert(p.size() == 5 && p.stored_elements() == 5 && p.is_full());
+  assert(p.sum() == 25 && p.min() == 3 && p.max() == 7 && p.window().head() == 3);
+  p.pop();
+  p.enqueue(8);
+  p.enqueue(9); //[5 6 7 8 9]
+  assert(p.stored_elements() == 5 && p.min() == 5 && p.sum() == 35);
+
+  window_cbuffer<double> f(4);
+  double samples[] = {1.5, -2.0, 4.0, 4.0, 0.5, 3.0};
+  for(double x : samples)
+    f.enqueue(x); //[4 4 0.5 3]
+  assert(f.is_full() && f.min() == 0.5 && f.max() == 4.0 && f.sum() == 11.5);
+  f.pop();
+  f.pop();
+  assert(f.min() == 0.5 && f.max() == 3.0 && f.mean() == 1.75);
+  f.recompute();
+  assert(f.sum() == 3.5 && f.variance() == 1.5625);
+  f.clear();
+  assert(f.is_empty() && f.sum() == 0);
+  try{
+    f.max();
+    assert(false);
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Test dei quantili sulla finestra scorrevole, confrontati con
+ * il nearest rank calcolato ordinando una copia della finestra
+ *  
+ */
+void test_quantile_cbuffer(){
+  double qs[] = {0.0, 0.01, 0.5, 0.95, 0.99, 1.0};
+  unsigned int sizes[] = {1, 2, 7, 100};
+  for(unsigned int size : sizes){
+    //intervalli di ampiezza 1: quantili esatti su valori interi
+    quantile_cbuffer<int, linear_buckets> w(size, linear_buckets(-100, 1, 201));
+    unsigned int seed = 4321;
+    for(int i = 0; i < 1000; ++i){
+      seed = seed * 1103515245u + 12345u;
+      w.enqueue(static_cast<int>((seed >> 16) % 201) - 100);
+      if(i % 89 == 0)
+        w.pop(); //la finestra può anche restringersi
+      if(w.is_empty())
+        continue;
+      std::vector<int> sorted(w.window().begin(), w.window().end());
+      std::sort(sorted.begin(), sorted.end());
+      for(double q : qs){
+        std::size_t rank = static_cast<std::size_t>(std::ceil(q * sorted.size()));
+        assert(w.quantile(q) == sorted[rank == 0 ? 0 : rank - 1]);
+      }
+    }
+  }
+
+  //latenze su più ordini di grandezza: errore relativo limitato
+  quantile_cbuffer<double> l(500, log_buckets(1, 1e7, 0.01));
+  double latency = 1;
+  for(int i = 0; i < 5000; ++i){
+    latency = latency * 1.37 > 1e6 ? 1 + i % 7 : latency * 1.37;
+    l.enqueue(latency);
+  }
+  std::vector<double> sorted(l.window().begin(), l.window().end());
+  std::sort(sorted.begin(), sorted.end());
+  for(double q : qs){
+    std::size_t rank = static_cast<std::size_t>(std::ceil(q * sorted.size()));
+    double exact = sorted[rank == 0 ? 0 : rank - 1];
+    assert(std::abs(l.quantile(q) - exact) <= 0.01 * exact + 1e-9);
+  }
+
+  //valori fuori range nei primi e negli ultimi intervalli
+  quantile_cbuffer<int, linear_buckets> c(3, linear_buckets(0, 10, 10));
+  c.enqueue(-5); c.enqueue(42); c.enqueue(1000);
+  assert(c.quantile(0) == 0 && c.quantile(0.5) == 40 && c.quantile(1) == 90);
+  c.clear();
+  assert(c.is_empty());
+  try{
+    c.quantile(0.5);
+    assert(false);
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  //con pow2_index la capacità viene arrotondata a 4, la finestra resta di 3 valori
+  quantile_cbuffer<int, linear_buckets, pow2_index> p(3, linear_buckets(0, 10, 10));
+  for(int v : {5, 15, 25, 35, 45})
+    p.enqueue(v); //[25 35 45]
+  assert(p.size() == 3 && p.stored_elements() == 3 && p.is_full());
+  assert(p.quantile(0) == 20 && p.quantile(1) == 40);
+  c.enqueue(1);
+  try{
+    c.quantile(1.5);
+    assert(false);
+  }catch(const std::out_of_range &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Test della coda mappata su file: ripristino alla riapertura
+ * e rifiuto di file danneggiati o incompatibili
+ *  
+ */
+void test_mapped_cbuffer(){
+  const char *path = "test_mapped_cbuffer.bin";
+  std::remove(path);
+  {
+    mapped_cbuffer<int> m(path, 4);
+    assert(m.is_empty() && m.size() == 4);
+    for(int i = 1; i <= 6; ++i)
+      m.enqueue(i); //[3 4 5 6]
+    assert(m.pop() == 3 && m.head() == 4 && m.tail() == 6);
+    m.enqueue(7); //[4 5 6 7], circolare
+    m[0] = 40;
+    m.flush();
+  }
+  {
+    mapped_cbuffer<int> m(path, 4); //ripristino
+    assert(m.is_full() && m[0] == 40 && m[1] == 5 && m[2] == 6 && m[3] == 7);
+    assert(m.array_one().second + m.array_two().second == 4);
+    m.enqueue(8); //[5 6 7 8]
+  }
+  {
+    mapped_cbuffer<int> m(path); //capacità letta dal file
+    assert(m.size() == 4 && m.head() == 5 && m.tail() == 8);
+    mapped_cbuffer<int> moved(std::move(m));
+    assert(m.size() == 0 && moved.pop() == 5 && moved.stored_elements() == 3);
+    moved.clear();
+  }
+  {
+    mapped_cbuffer<int, pow2_index> m(path, 3); //capacità 4 per entrambe le politiche
+    assert(m.is_empty());
+    for(int i = 0; i < 10; ++i)
+      m.enqueue(i);
+    assert(m.head() == 6 && m.tail() == 9);
+    try{
+      m[4];
+      assert(false);
+    }catch(const std::out_of_range &e){
+      std::cout<< e.what() <<std::endl;
+    }
+  }
+
+  for(int round = 0; round < 5; ++round){ //processo terminato durante le sovrascritture
+    pid_t child = fork();
+    if(child == 0){
+      mapped_cbuffer<int> m(path, 4);
+      m.clear();
+      for(int i = 0; ; ++i)
+        m.enqueue(i);
+    }
+    usleep(2000 + 3000 * round);
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    mapped_cbuffer<int> m(path, 4); //gli elementi pubblicati sono consecutivi
+    for(unsigned int i = 1; i < m.stored_elements(); ++i)
+      assert(m[i] == m[i - 1] + 1);
+  }
+
+  try{
+    mapped_cbuffer<int> m(path, 5); //capacità diversa
+    assert(false);
+  }catch(const invalid_file_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  try{
+    mapped_cbuffer<double> m(path, 4); //elementi di dimensione diversa
+    assert(false);
+  }catch(const invalid_file_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  {
+    const char *odd = "test_mapped_cbuffer_5.bin";
+    {
+      mapped_cbuffer<int> m(odd, 5);
+      m.enqueue(1);
+    }
+    try{
+      mapped_cbuffer<int, pow2_index> m(odd); //capacità 5 non valida per pow2_index
+      assert(false);
+    }catch(const invalid_file_exception &e){
+      std::cout<< e.what() <<std::endl;
+    }
+    std::remove(odd);
+  }
+  std::FILE *file = std::fopen(path, "r+b");
+  std::fputc('X', file); //firma danneggiata
+  std::fclose(file);
+  try{
+    mapped_cbuffer<int> m(path);
+    assert(false);
+  }catch(const invalid_file_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  std::remove(path);
+  try{
+    mapped_cbuffer<int> m(path); //il file non esiste
+    assert(false);
+  }catch(const std::system_error &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Test della coda in memoria condivisa: due oggetti sullo stesso
+ * segmento nello stesso processo, poi un consumatore in un processo figlio
+ *  
+ */
+void test_shm_spsc_cbuffer(){
+  std::string name = "/cbuffer_test_" + std::to_string(getpid());
+  shm_spsc_cbuffer<long long, block_on_full>::unlink(name);
+  {
+    shm_spsc_cbuffer<long long, block_on_full> producer(name, 100);
+    shm_spsc_cbuffer<long long, block_on_full> consumer(name);
+    assert(producer.size() == 128 && consumer.size() == 128 && consumer.is_empty());
+    long long x = 0;
+    assert(!consumer.try_dequeue(x));
+    for(int i = 0; i < 128; ++i)
+      assert(producer.try_enqueue(i));
+    assert(consumer.is_full() && !producer.try_enqueue(128));
+    for(int i = 0; i < 128; ++i)
+      assert(consumer.try_dequeue(x) && x == i);
+
+    try{
+      shm_spsc_cbuffer<long long> again(name, 8); //il segmento esiste già
+      assert(false);
+    }catch(const std::system_error &e){
+      std::cout<< e.what() <<std::endl;
+    }
+    try{
+      shm_spsc_cbuffer<int> other(name); //elementi di un altro tipo
+      assert(false);
+    }catch(const invalid_file_exception &e){
+      std::cout<< e.what() <<std::endl;
+    }
+    {
+      int fd = shm_open(name.c_str(), O_RDWR, 0);
+      assert(fd >= 0);
+      void *p = mmap(nullptr, sizeof(shm_spsc_header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      assert(p != MAP_FAILED);
+      close(fd);
+      shm_spsc_header *h = static_cast<shm_spsc_header*>(p);
+      for(std::uint32_t capacity : {0u, 100u}){ //header corrotto
+        h->capacity = capacity;
+        try{
+          shm_spsc_cbuffer<long long> corrupted(name);
+          assert(false);
+        }catch(const invalid_file_exception &e){
+          std::cout<< e.what() <<std::endl;
+        }
+      }
+      h->capacity = 128;
+      munmap(p, sizeof(shm_spsc_header));
+    }
+
+    const long long n = 200000;
+    std::cout.flush();
+    pid_t child = fork();
+    if(child == 0){
+      shm_spsc_cbuffer<long long, block_on_full> reader(name); //mappato a un altro indirizzo
+      long long value = 0;
+      for(long long i = 0; i < n; ++i){
+        reader.dequeue(value);
+        if(value != i * 3)
+          _exit(1);
+      }
+      _exit(0);
+    }
+    assert(child > 0);
+    for(long long i = 0; i < n; ++i)
+      producer.enqueue(i * 3);
+    int status = 0;
+    assert(waitpid(child, &status, 0) == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(consumer.is_empty());
+  }
+  try{
+    shm_spsc_cbuffer<long long> removed(name); //il proprietario ha rimosso il segmento
+    assert(false);
+  }catch(const std::system_error &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Test della coda a doppia mappatura: stesse operazioni di un
+ * cbuffer di riferimento, con i dati sempre contigui dalla testa
+ *  
+ */
+void test_mirrored_cbuffer(){
+  mirrored_cbuffer<int> m(10);
+  assert(m.size() % 1024 == 0 && m.is_empty() && m.begin() == m.end());
+  cbuffer<int> reference(m.size());
+  std::vector<int> chunk(m.size() + 100), out(m.size());
+  unsigned int seed = 777;
+  for(int round = 0; round < 2000; ++round){
+    seed = seed * 1103515245u + 12345u;
+    unsigned int n = (seed >> 16) % (m.size() + 50);
+    switch(round % 4){
+      case 0:
+        for(unsigned int i = 0; i < n % 300; ++i){
+          m.enqueue(round + i);
+          reference.enqueue(round + i);
+        }
+        break;
+      case 1:
+        std::iota(chunk.begin(), chunk.begin() + n, round * 10);
+        assert(m.enqueue_range(chunk.data(), chunk.data() + n) == n);
+        reference.enqueue_range(chunk.begin(), chunk.begin() + n);
+        break;
+      case 2:{
+        unsigned int k = m.dequeue_into(out.data(), n % 500);
+        for(unsigned int i = 0; i < k; ++i)
+          assert(out[i] == reference.pop());
+        break;
+      }
+      default:
+        if(!m.is_empty())
+          assert(m.pop() == reference.pop());
+    }
+    //un solo intervallo contiguo anche quando la coda è circolare
+    assert(m.stored_elements() == reference.stored_elements());
+    assert(std::equal(m.begin(), m.end(), reference.begin()));
+    assert(m.array_one().second == m.stored_elements() && m.array_two().second == 0);
+    if(!m.is_empty())
+      assert(m[0] == reference.head() && m.tail() == reference.tail() && &m.tail() == m.end() - 1);
+  }
+
+  mirrored_cbuffer<int> copy(m);
+  assert(std::equal(copy.begin(), copy.end(), m.begin(), m.end()));
+  copy.enqueue(-1);
+  assert(copy.tail() == -1 && (m.is_empty() || m.tail() != -1)); //la copia ha pagine proprie
+  mirrored_cbuffer<int> moved(std::move(copy));
+  assert(copy.size() == 0 && moved.tail() == -1);
+  m = moved;
+  assert(m.tail() == -1 && m.stored_elements() == moved.stored_elements());
+
+  struct record{ int a; double b; int c; }; //24 byte: 512 elementi per 3 pagine
+  mirrored_cbuffer<record, reject_on_full> r(1);
+  assert(r.size() * sizeof(record) % 4096 == 0);
+  for(unsigned int i = 0; i < r.size(); ++i)
+    assert(r.enqueue(record{int(i), 0.5, 0}));
+  assert(!r.enqueue(record{-1, 0, 0}) && r.pop().a == 0);
+  assert(r.enqueue(record{-1, 0, 0}) && r.tail().a == -1 && r[r.size() - 2].a == int(r.size()) - 1);
+  record extra[3] = {};
+  assert(r.enqueue_range(extra, extra + 3) == 0);
+
+  mirrored_cbuffer<char> empty;
+  try{
+    empty.enqueue('x');
+    assert(false);
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Funzione di supporto per test_record_cbuffer: inserisce e
+ * rimuove record di lunghezza casuale confrontando il contenuto con una
+ * std::deque<std::string> di riferimento
+ *
+ * @tparam Overflow politica di inserimento su coda piena
+ * @param size dimensione dell'area in byte
+ */
+template<typename Overflow> void check_record_cbuffer(int size){
+  record_cbuffer<Overflow> r(size);
+  std::deque<std::string> reference;
+  unsigned int seed = size;
+  for(int i = 0; i < 20000; ++i){
+    seed = seed * 1103515245u + 12345u;
+    unsigned int n = (seed >> 16) % (r.max_record_size() / 3 + 2);
+    if((seed >> 8) % 3 != 0){
+      std::string line(n, static_cast<char>('a' + i % 26));
+      if(n > 0)
+        line[0] = static_cast<char>(i);
+      unsigned char *p = r.reserve(n + 10); //riservo più del necessario
+      if(p == nullptr){
+        assert((std::is_same<Overflow, reject_on_full>::value) || n + 10 > r.max_record_size());
+        continue;
+      }
+      assert(reinterpret_cast<std::uintptr_t>(p) % 4 == 0);
+      std::copy(line.begin(), line.end(), p);
+      r.commit(n);
+      reference.push_back(line);
+      while(reference.size() > r.stored_elements()) //record più vecchi sovrascritti
+        reference.pop_front();
+    }else if(!r.is_empty()){
+      typename record_cbuffer<Overflow>::const_record head = r.peek();
+      assert(std::string(head.first, head.first + head.second) == reference.front());
+      r.release();
+      reference.pop_front();
+    }
+    assert(r.stored_elements() == reference.size() && r.used_bytes() <= r.size());
+  }
+  record_cbuffer<Overflow> copy(r);
+  for(const std::string &line : reference){
+    typename record_cbuffer<Overflow>::const_record head = copy.peek();
+    assert(std::string(head.first, head.first + head.second) == line);
+    copy.release();
+  }
+  assert(copy.is_empty() && copy.used_bytes() == 0 && r.stored_elements() == reference.size());
+}
+
+/**
+ * @brief Test della coda di record di lunghezza variabile
+ *  
+ */
+void test_record_cbuffer(){
+  check_record_cbuffer<overwrite_on_full>(64);
+  check_record_cbuffer<overwrite_on_full>(1000);
+  check_record_cbuffer<reject_on_full>(64);
+  check_record_cbuffer<reject_on_full>(1000);
+
+  record_cbuffer<reject_on_full> r(32); //record da 4 + 8 byte: al più due e mezzo
+  assert(r.enqueue("aaaaaaaa", 8) && r.enqueue("bbbbbbbb", 8));
+  assert(!r.enqueue("cccccccc", 8) && r.used_bytes() == 24);
+  r.release(); //[b], libero: 8 byte alla fine e 12 all'inizio
+  assert(r.enqueue("cccccccc", 8)); //riempimento alla fine e record all'inizio
+  assert(r.used_bytes() == 32 && r.stored_elements() == 2);
+  assert(std::string(reinterpret_cast<const char*>(r.peek().first), 8) == "bbbbbbbb");
+  r.release(); //salta anche il riempimento
+  assert(std::string(reinterpret_cast<const char*>(r.peek().first), 8) == "cccccccc" && r.used_bytes() == 12);
+  r.release();
+  assert(r.is_empty() && r.used_bytes() == 0);
+  assert(r.reserve(r.max_record_size() + 1) == nullptr && r.reserve(r.max_record_size()) != nullptr);
+  r.commit(0); //record vuoto
+  assert(r.peek().second == 0);
+
+  record_cbuffer<> o(32);
+  o.enqueue("1234", 4);
+  o.enqueue("5678", 4);
+  o.enqueue("9", 1);
+  o.enqueue("abcdefghijklmnopqrstuvw", 23); //scarta tutti i precedenti
+  assert(o.stored_elements() == 1 && o.peek().second == 23);
+  try{
+    o.commit(1);
+    assert(false);
+  }catch(const std::logic_error &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  o.reserve(4);
+  try{
+    o.commit(5);
+    assert(false);
+  }catch(const std::out_of_range &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  o.clear();
+  try{
+    o.peek();
+    assert(false);
+  }catch(const empty_queue_exception &e){
+    std::cout<< e.what() <<std::endl;
+  }
+}
+
+/**
+ * @brief Test di write_to_fd e read_from_fd: su file con la coda circolare,
+ * poi su una pipe non bloccante con elementi da 12 byte, in modo che le
+ * scritture parziali spezzino gli elementi
+ *  
+ */
+void test_fd_io(){
+  const char *path = "test_fd_io.bin";
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  assert(fd >= 0);
+  cbuffer<int> out(1000);
+  for(int i = 0; i < 1700; ++i)
+    out.enqueue(i); //[700 ... 1699], circolare
+  assert(out.write_to_fd(fd) == 1000 && out.is_empty());
+  assert(out.write_to_fd(fd) == 0);
+  lseek(fd, 0, SEEK_SET);
+  cbuffer<int, pow2_index> in(700); //capacità 1024
+  in.enqueue(-1);
+  in.pop();
+  in.enqueue(-2); //la testa non è all'inizio dell'array
+  assert(in.read_from_fd(fd, 2000) == 1000);
+  assert(in.stored_elements() == 1001 && in[0] == -2 && in[1] == 700 && in.tail() == 1699);
+  assert(in.read_from_fd(fd, 10) == 0); //fine del file
+  close(fd);
+  std::remove(path);
+
+  struct triple{ int a, b, c; };
+  int fds[2];
+  assert(pipe(fds) == 0);
+  fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+  const int n = 100000;
+  std::thread reader([&fds](){
+    cbuffer<triple> received(1000);
+    int expected = 0;
+    unsigned int r;
+    while((r = received.read_from_fd(fds[0], 1000)) > 0){
+      for(unsigned int i = 0; i < r; ++i){
+        triple t = received.pop();
+        assert(t.a == expected && t.b == -expected && t.c == 7);
+        ++expected;
+      }
+    }
+    assert(expected == n);
+  });
+  cbuffer<triple> sent(4096);
+  int next = 0;
+  while(next < n || !sent.is_empty()){
+    while(next < n && !sent.is_full()){
+      sent.enqueue(triple{next, -next, 7});
+      ++next;
+    }
+    if(sent.write_to_fd(fds[1]) == 0) //pipe piena: EAGAIN
+      std::this_thread::yield();
+  }
+  close(fds[1]);
+  reader.join();
+  close(fds[0]);
+}
+
+/**
+ * @brief Test del parametro Allocator: std::pmr::polymorphic_allocator con
+ * un block_pool (riciclo dell'array, copia e spostamento tra risorse
+ * diverse) e pool_allocator
+ *  
+ */
+void test_cbuffer_allocator(){
+  typedef cbuffer<std::string, modulo_index, overwrite_on_full, std::pmr::polymorphic_allocator<std::string>> pmr_cbuffer;
+  block_pool pool;
+  const std::string *array;
+  {
+    pmr_cbuffer b(100, &pool);
+    assert(b.get_allocator().resource() == &pool);
+    for(int i = 0; i < 150; ++i)
+      b.enqueue(std::to_string(i));
+    assert(b.head() == "50" && b.tail() == "149");
+    array = b.array_two().first; // inizio dell'array (la coda è circolare)
+  }
+  assert(pool.cached_blocks() == 1);
+  {
+    pmr_cbuffer b(100, &pool); // stesso blocco, senza allocare
+    assert(pool.cached_blocks() == 0 && b.array_one().first == array);
+    b.enqueue("y");
+    pmr_cbuffer other(10, &pool); // altra dimensione
+    other.enqueue("x");
+  }
+  assert(pool.cached_blocks() == 2);
+
+  block_pool other_pool;
+  pmr_cbuffer a(4, &pool);
+  a.enqueue("a");
+  a.enqueue("b");
+  a.enqueue("c");
+  pmr_cbuffer c(a);
+  assert(c.get_allocator().resource() == std::pmr::get_default_resource());
+  assert(c.stored_elements() == 3 && c[2] == "c");
+  pmr_cbuffer d(2, &other_pool);
+  d = a; // l'allocatore polimorfico non si propaga
+  assert(d.get_allocator().resource() == &other_pool && d.size() == 4 && d[0] == "a");
+  pmr_cbuffer e(2, &other_pool);
+  e = std::move(a); // risorse diverse: elementi spostati uno a uno
+  assert(e.get_allocator().resource() == &other_pool);
+  assert(e.stored_elements() == 3 && e.head() == "a" && e.tail() == "c");
+  assert(a.size() == 0 && a.is_empty());
+  pmr_cbuffer f(1, &other_pool);
+  f = std::move(e); // stessa risorsa: l'array viene rubato
+  assert(f.stored_elements() == 3 && e.size() == 0);
+  assert(accumulate(f, std::string()) == "abc");
+
+  typedef cbuffer<int, pow2_index, overwrite_on_full, pool_allocator<int>> pooled_cbuffer;
+  block_pool &local = *static_cast<block_pool*>(block_pool::local());
+  const int *first = nullptr;
+  for(int round = 0; round < 10; ++round){
+    pooled_cbuffer b(1000);
+    for(int i = 0; i < 1500; ++i)
+      b.enqueue(i);
+    assert(b.size() == 1024 && b.head() == 476 && b.tail() == 1499);
+    if(round == 0)
+      first = b.array_two().first;
+    else
+      assert(b.array_two().first == first); // array riciclato dal pool del thread
+    pooled_cbuffer copy(b);
+    pooled_cbuffer moved(std::move(copy));
+    assert(moved.stored_elements() == 1024 && moved[1023] == 1499);
+  }
+  assert(local.cached_blocks() >= 2);
+  assert(pooled_cbuffer().get_allocator() == pool_allocator<double>());
+}
+
+/**
+ * @brief Funzione constexpr che usa uno static_cbuffer in un'espressione
+ * costante: 6 inserimenti in 4 slot, poi la somma con gli iteratori
+ *
+ * @return int somma degli elementi rimasti (3 + 4 + 5 + 6 - 3)
+ */
+constexpr int static_cbuffer_constexpr_sum(){
+  static_cbuffer<int, 4> b;
+  for(int i = 1; i <= 6; ++i)
+    b.enqueue(i);
+  int sum = 0;
+  for(static_cbuffer<int, 4>::const_iterator it = b.begin(); it != b.end(); ++it)
+    sum += *it;
+  return sum - b.pop();
+}
+
+/**
+ * @brief Funzione constexpr che accoda e rimuove blocchi di elementi
+ * che attraversano la fine dell'array di uno static_cbuffer
+ *
+ * @return int somma degli elementi rimossi con dequeue_into (4 + 5 + 6 + 7)
+ */
+constexpr int static_cbuffer_constexpr_segments(){
+  int in[7] = {1, 2, 3, 4, 5, 6, 7};
+  static_cbuffer<int, 5> b(in, in + 3);
+  b.pop();
+  b.pop();
+  b.enqueue_range(in + 3, in + 7); // [3 4 5 6 7], testa in 2
+  static_cbuffer<int, 5> copy(b);
+  int out[5] = {};
+  copy.pop();
+  unsigned int n = copy.dequeue_into(out, 10);
+  return n == 4 && b.stored_elements() == 5 ? out[0] + out[1] + out[2] + out[3] : -1;
+}
+
+/**
+ * @brief Test su static_cbuffer: capacità a tempo di compilazione,
+ * dati nell'oggetto, uso in espressioni costanti e stessa interfaccia di cbuffer
+ *  
+ */
+void test_static_cbuffer(){
+  static_assert(static_cbuffer_constexpr_sum() == 15, "constexpr static_cbuffer");
+  static_assert(static_cbuffer_constexpr_segments() == 22, "constexpr enqueue_range e dequeue_into");
+  static_assert(sizeof(static_cbuffer<int, 8>) == 8 * sizeof(int) + 2 * sizeof(unsigned int), "inline storage");
+  static_assert(static_cbuffer<double, 5>::size() == 5, "constexpr capacity");
+
+  static_cbuffer<int, 5> a;
+  assert(a.is_empty() && a.size() == 5);
+  for(int i = 0; i < 7; ++i)
+    a.enqueue(i);
+  assert(a.is_full() && a.head() == 2 && a.tail() == 6 && a[4] == 6);
+  assert(a.array_one().second == 3 && a.array_two().second == 2 && a.array_two().first[0] == 5);
+  assert(std::accumulate(a.begin(), a.end(), 0) == 20);
+  std::vector<int> sorted(a.begin(), a.end());
+  assert(std::is_sorted(sorted.begin(), sorted.end()));
+  static_cbuffer<int, 5>::iterator it = a.begin() + 2;
+  static_cbuffer<int, 5>::const_iterator cit = it;
+  assert(*cit == 4 && a.end() - it == 3 && it[1] == 5);
+  assert(a.pop() == 2 && a.pop_tail() == 6 && a.stored_elements() == 3);
+  int out[3];
+  assert(a.dequeue_into(out, 10) == 3 && out[0] == 3 && out[2] == 5 && a.is_empty());
+  try{
+    a.pop();
+    assert(false);
+  }catch(const empty_queue_exception &){
+  }
+  try{
+    a[0];
+    assert(false);
+  }catch(const std::out_of_range &){
+  }
+  assert(!a.try_pop() && a.try_front() == nullptr);
+
+  static_cbuffer<std::string, 3, reject_on_full> s;
+  assert(s.enqueue("a") && s.try_emplace(2, 'b') && s.enqueue("c"));
+  assert(!s.enqueue("d") && !s.try_emplace("e") && s.tail() == "c");
+  assert(s.head() == "a" && s[1] == "bb");
+  std::string x;
+  assert(s.try_dequeue(x) && x == "a");
+  s.enqueue("d");
+  assert(s.array_two().second == 1);
+  s.linearize();
+  assert(s.array_one().second == 3 && s[0] == "bb" && s[2] == "d");
+  static_cbuffer<std::string, 4> w;
+  for(const char *v : {"p", "q", "r", "s"})
+    w.enqueue(v);
+  w.pop();
+  w.pop();
+  w.pop();
+  w.enqueue("t"); // [t _ _ s]: il primo segmento viene spostato negli slot liberi
+  assert(w.linearize().second == 2 && w[0] == "s" && w[1] == "t" && w.array_two().second == 0);
+  static_cbuffer<std::string, 3, reject_on_full> copy(s);
+  s.clear();
+  assert(s.is_empty() && copy.stored_elements() == 3 && copy.tail() == "d");
+  std::stringstream ss;
+  ss << copy;
+  assert(ss.str().find("[ bb c d ]") != std::string::npos);
+
+  std::list<int> l = {1, 2, 3, 4};
+  static_cbuffer<int, 3> r(l.begin(), l.end());
+  assert(r.head() == 2 && r.tail() == 4);
+  assert(r.emplace(5) == 5 && r.head() == 3);
+  const static_cbuffer<int, 3> &cr = r;
+  assert(r.begin() == cr.begin() && cr.begin() + 3 == r.end()); // iterator e const_iterator confrontabili
+
+  // slot non inizializzati: T senza costruttore di default, elementi costruiti in loco
+  {
+    static_cbuffer<counted, 4> c;
+    assert(counted::alive == 0);
+    for(int i = 0; i < 3; ++i)
+      c.emplace(i);
+    assert(counted::alive == 3);
+    c.emplace(3);
+    c.emplace(4); // sostituisce 0
+    assert(counted::alive == 4 && c.head().value == 1 && c.tail().value == 4);
+    static_cbuffer<counted, 4> d(c);
+    assert(counted::alive == 8 && d.array_two().second == 0 && c.array_two().second == 1);
+    c.linearize();
+    assert(counted::alive == 8 && c.array_one().second == 4 && c[0].value == 1 && c[3].value == 4);
+    std::vector<counted> v;
+    v.reserve(4);
+    assert(c.dequeue_into(std::back_inserter(v), 3) == 3 && counted::alive == 8);
+    assert(v[0].value == 1 && v[2].value == 3 && c.head().value == 4);
+    std::vector<counted> more(6, counted(9));
+    assert(c.enqueue_range(more.begin(), more.end()) == 6 && c.is_full() && c.head().value == 9);
+    assert(counted::alive == 4 + 4 + 3 + 6);
+    c = d;
+    assert(counted::alive == 17 && c[3].value == 4);
+    c.pop_tail();
+    c.clear();
+    assert(counted::alive == 13 && c.is_empty());
+    static_cbuffer<counted, 4, reject_on_full> e;
+    assert(e.enqueue_range(more.begin(), more.end()) == 4 && !e.try_emplace(1) && counted::alive == 17);
+  }
+  assert(counted::alive == 0);
+}
+
+/**
+ * @brief Funzione che ritorna true se p punta dentro l'oggetto o
+ *
+ * @tparam O tipo dell'oggetto
+ * @param o oggetto
+ * @param p puntatore da controllare
+ * @return true se p è nell'intervallo di byte occupato da o
+ */
+template<typename O> bool points_inside(const O &o, const void *p){
+  const char *c = static_cast<const char*>(p);
+  return c >= reinterpret_cast<const char*>(&o) && c < reinterpret_cast<const char*>(&o + 1);
+}
+
+/**
+ * @brief Test su small_cbuffer: dati nell'oggetto fino a K elementi,
+ * array allocato oltre, copie e spostamenti tra i due casi
+ *  
+ */
+void test_small_cbuffer(){
+  static_assert(sizeof(small_cbuffer<int, 16>) == sizeof(cbuffer<int>) + 16 * sizeof(int), "inline slots");
+
+  small_cbuffer<int, 16> a(10);
+  for(int i = 0; i < 15; ++i)
+    a.enqueue(i);
+  assert(points_inside(a, a.array_one().first) && a.head() == 5 && a.tail() == 14);
+  assert(a.array_two().second == 5 && accumulate(a, 0) == 95);
+  small_cbuffer<int, 16> big(100);
+  for(int i = 0; i < 100; ++i)
+    big.enqueue(i);
+  assert(!points_inside(big, big.array_one().first));
+
+  small_cbuffer<int, 16> moved(std::move(a)); // dati nell'oggetto: spostati
+  assert(points_inside(moved, moved.array_one().first) && a.size() == 0 && a.is_empty());
+  assert(moved.stored_elements() == 10 && moved[0] == 5 && moved[9] == 14);
+  const int *array = big.array_one().first;
+  small_cbuffer<int, 16> stolen(std::move(big)); // array allocato: preso
+  assert(stolen.array_one().first == array && stolen.tail() == 99 && big.size() == 0);
+
+  a = stolen; // oggetto vuoto <- array allocato
+  assert(a.size() == 100 && !points_inside(a, a.array_one().first) && a[50] == 50);
+  a = moved; // array allocato <- dati nell'oggetto
+  assert(a.size() == 10 && points_inside(a, a.array_one().first) && a.head() == 5);
+  stolen = std::move(a);
+  assert(stolen.size() == 10 && points_inside(stolen, stolen.array_one().first) && stolen.tail() == 14);
+  moved = std::move(stolen);
+  assert(moved.stored_elements() == 10 && stolen.size() == 0);
+
+  small_cbuffer<double, 8> x(4); // riduzioni e algoritmi con allocatori diversi
+  cbuffer<double, pow2_index, overwrite_on_full, pool_allocator<double>> y(4);
+  for(int i = 1; i <= 6; ++i){
+    x.enqueue(i);
+    y.enqueue(2.0 * i);
+  }
+  assert(simd_dot(x, y) == 2.0 * (9 + 16 + 25 + 36) && simd_dot(y, x) == simd_dot(x, y));
+  assert(simd_sum(x) == 18 && simd_min(y) == 6 && simd_max(x) == 6 && simd_mean(y) == 9);
+  assert(count_if(x, [](double v){ return v > 4; }) == 2 && *find(y, 8.0) == 8);
+
+  small_cbuffer<int, 8> zero(0); // capacità 0: spostamento e copia senza slot
+  small_cbuffer<int, 8> zero_moved(std::move(zero));
+  assert(zero_moved.size() == 0 && zero_moved.is_empty());
+  small_cbuffer<int, 8> target(3);
+  target.enqueue(1);
+  target = zero_moved;
+  assert(target.size() == 0 && target.is_empty());
+  zero = std::move(target);
+  assert(zero.size() == 0);
+  small_cbuffer<int, 8> shrunk(4);
+  shrunk.enqueue(1);
+  shrunk.resize_capacity(0);
+  small_cbuffer<int, 8> shrunk_moved(std::move(shrunk));
+  assert(shrunk_moved.size() == 0 && shrunk_moved.is_empty());
+
+  small_cbuffer<int, 8, pow2_index> p(5); // capacità 8: ancora nell'oggetto
+  assert(p.size() == 8 && points_inside(p, p.array_one().first));
+  assert(p.get_allocator() == std::allocator<int>());
+
+  {
+    small_cbuffer<counted, 4> c(3), d(20);
+    for(int i = 0; i < 5; ++i){
+      c.enqueue(counted(i));
+      d.enqueue(counted(i));
+    }
+    assert(counted::alive == 8);
+    small_cbuffer<counted, 4> e(std::move(c));
+    assert(counted::alive == 8 && e.head().value == 2);
+    d = e;
+    assert(counted::alive == 6 && d.size() == 3 && d.tail().value == 4);
+    e = std::move(d);
+    assert(counted::alive == 3 && e.stored_elements() == 3);
+  }
+  assert(counted::alive == 0);
+}
+
+/**
+ * @brief Test su reserve, resize_capacity e grow_on_full: gli elementi
+ * restano in ordine FIFO quando la capacità cambia, anche con i dati su
+ * due segmenti, nell'oggetto (small_buffer_allocator) o non copiabili
+ *  
+ */
+void test_grow_cbuffer(){
+  cbuffer<int> b(4);
+  for(int i = 0; i < 6; ++i)
+    b.enqueue(i); //[2 3 4 5] su due segmenti
+  b.reserve(3);
+  assert(b.size() == 4);
+  b.reserve(10);
+  assert(b.size() == 10 && b.stored_elements() == 4 && b.array_two().second == 0);
+  assert(b.head() == 2 && b.tail() == 5);
+  for(int i = 6; i < 12; ++i)
+    b.enqueue(i);
+  assert(b.is_full() && b.head() == 2);
+  b.resize_capacity(3); // restano i più recenti
+  assert(b.size() == 3 && b.stored_elements() == 3 && b.head() == 9 && b.tail() == 11);
+  b.resize_capacity(0);
+  assert(b.size() == 0 && b.is_empty());
+
+  //allocazione non riuscita: la coda non cambia, nemmeno riducendo la capacità
+  alignas(int) unsigned char arena[80];
+  std::pmr::monotonic_buffer_resource once(arena, sizeof(arena), std::pmr::null_memory_resource());
+  cbuffer<int, modulo_index, overwrite_on_full, std::pmr::polymorphic_allocator<int>> r(16, &once);
+  for(int i = 0; i < 20; ++i)
+    r.enqueue(i); //[4 ... 19]
+  try{
+    r.resize_capacity(8);
+    assert(false);
+  }catch(const std::bad_alloc &){
+  }
+  assert(r.size() == 16 && r.stored_elements() == 16 && r.head() == 4 && r.tail() == 19);
+
+  //capacità oltre la potenza di due più grande: errore invece di un ciclo infinito
+  assert(pow2_index::capacity(pow2_index::max_capacity) == 1u << 31);
+  cbuffer<int, pow2_index> big(3);
+  big.enqueue(1);
+  try{
+    big.reserve(3000000000u);
+    assert(false);
+  }catch(const std::length_error &e){
+    std::cout<< e.what() <<std::endl;
+  }
+  try{
+    big.resize_capacity(pow2_index::max_capacity + 1);
+    assert(false);
+  }catch(const std::length_error &){
+  }
+  assert(big.size() == 4 && big.head() == 1);
+
+  cbuffer<int, modulo_index, grow_on_full> f;
+  std::deque<int> model;
+  int next = 0;
+  for(int round = 0; round < 200; ++round){
+    for(int i = 0; i < 7; ++i){
+      f.enqueue(next);
+      model.push_back(next++);
+    }
+    for(int i = 0; i < 3; ++i){
+      assert(f.pop() == model.front());
+      model.pop_front();
+    }
+    assert(f.stored_elements() == model.size() && f.size() >= f.stored_elements());
+  }
+  assert(std::equal(f.begin(), f.end(), model.begin()));
+  assert(f.size() == 1024);
+  while(!f.is_full())
+    f.enqueue(f.tail() + 1);
+  f.enqueue(f.head()); // elemento della coda inserito mentre la capacità raddoppia
+  assert(f.size() == 2048 && f.tail() == model.front());
+  std::vector<int> more(5000, 7);
+  assert(f.enqueue_range(more.begin(), more.end()) == 5000 && f.tail() == 7);
+  assert(f.size() == 6025 && f.is_full()); // almeno il doppio o quanto serve
+
+  cbuffer<int, pow2_index, grow_on_full> p;
+  assert(p.try_enqueue(1) && p.size() == 1);
+  for(int i = 2; i <= 100; ++i)
+    p.emplace(i);
+  assert(p.size() == 128 && p.head() == 1 && p.tail() == 100 && p[50] == 51);
+  p.resize_capacity(40); // arrotondata a 64
+  assert(p.size() == 64 && p.stored_elements() == 64 && p.head() == 37);
+
+  cbuffer<std::unique_ptr<int>, modulo_index, grow_on_full> u(2);
+  for(int i = 0; i < 5; ++i)
+    u.emplace(new int(i));
+  assert(u.size() == 8 && *u.head() == 0 && *u.tail() == 4);
+
+  typedef cbuffer<int, modulo_index, grow_on_full, small_buffer_allocator<int, 8>> small_growing;
+  small_growing s(4);
+  for(int i = 0; i < 6; ++i)
+    s.enqueue(i);
+  assert(s.size() == 8 && points_inside(s, s.array_one().first)); // ancora nell'oggetto
+  for(int i = 6; i < 9; ++i)
+    s.enqueue(i);
+  assert(s.size() == 16 && !points_inside(s, s.array_one().first));
+  s.resize_capacity(5);
+  assert(points_inside(s, s.array_one().first) && s.head() == 4 && s.tail() == 8);
+
+  small_cbuffer<std::string, 8> h(8); // dati contigui con la testa lontana dall'inizio
+  for(int i = 1; i <= 5; ++i)
+    h.enqueue(std::to_string(i));
+  for(int i = 0; i < 4; ++i)
+    h.pop();
+  h.resize_capacity(2);
+  assert(h.size() == 2 && h.stored_elements() == 1 && h.head() == "5" && h.tail() == "5");
+  assert(h.array_one().first == h.array_two().first); // testa nel primo slot
+  h.enqueue("6");
+  h.enqueue("7");
+  assert(h.head() == "6" && h.tail() == "7");
+  {
+    small_cbuffer<counted, 8> c(8);
+    for(int i = 0; i < 6; ++i)
+      c.enqueue(counted(i));
+    for(int i = 0; i < 3; ++i)
+      c.pop();
+    c.resize_capacity(4); // [3 4 5] dalla posizione 3 alla 0, sovrapposti
+    assert(counted::alive == 3 && c[0].value == 3 && c[2].value == 5);
+  }
+  assert(counted::alive == 0);
+
+  {
+    cbuffer<counted, modulo_index, grow_on_full> c(1);
+    for(int i = 0; i < 100; ++i)
+      c.enqueue(counted(i));
+    assert(counted::alive == 100 && c.size() == 128);
+    c.resize_capacity(10);
+    assert(counted::alive == 10 && c.head().value == 90);
+  }
+  assert(counted::alive == 0);
+}
+
 int main(){
   cbuffer<int> buffer_int(20);
   cbuffer<person> buffer_person(5);
@@ -971,6 +2554,29 @@ int main(){
   test_const_iterator_string(buffer_string);
   test_const_iterator_person(buffer_person);
   test_cbuffer_of_cbuffer();
+  test_uninitialized_storage();
+  test_move_semantics();
+  test_pow2_index();
+  test_bulk_operations();
+  test_array_ranges();
+  test_spsc_cbuffer();
+  test_mpmc_cbuffer();
+  test_try_api();
+  test_overflow_policy();
+  test_random_access_iterator();
+  test_segmented_algorithms();
+  test_simd_reductions();
+  test_window_cbuffer();
+  test_quantile_cbuffer();
+  test_mapped_cbuffer();
+  test_shm_spsc_cbuffer();
+  test_mirrored_cbuffer();
+  test_record_cbuffer();
+  test_fd_io();
+  test_cbuffer_allocator();
+  test_static_cbuffer();
+  test_small_cbuffer();
+  test_grow_cbuffer();
 
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,549 @@
+#ifndef MAPPED_CBUFFER_H
+#define MAPPED_CBUFFER_H
+#include <algorithm> // std::min
+#include <cerrno>
+#include <cstddef> // offsetof
+#include <cstdint>
+#include <cstring> // std::memcpy, std::memcmp
+#include <stdexcept> // std::out_of_range
+#include <string>
+#include <system_error>
+#include <type_traits> // std::is_trivially_copyable
+#include <utility> // std::pair, std::swap
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "negative_queue_size_exception.h"
+#include "empty_queue_exception.h"
+#include "invalid_file_exception.h"
+#include "cbuffer_index.h"
+
+/**
+ * @brief Intestazione all'inizio del file di un mapped_cbuffer
+ *
+ * I dati seguono l'intestazione, a partire dal byte 64. Il checksum
+ * copre i campi che descrivono il formato (firma, versione, dimensione
+ * degli elementi e capacità), che non cambiano dopo la creazione.
+ * Testa e numero di elementi sono nello stesso campo a 64 bit, scritto
+ * con un'unica istruzione dopo i dati, e uno slot viene scritto solo
+ * quando il campo pubblicato non lo considera occupato: se il processo
+ * termina a metà di un'operazione il file contiene lo stato precedente
+ * o quello successivo, oppure, durante la sovrascrittura di una coda
+ * piena, lo stato precedente senza l'elemento più vecchio.
+ * La coda (posizione del prossimo inserimento) è testa + numero di elementi.
+ */
+struct alignas(64) mapped_cbuffer_header{
+    char magic[8]; ///< firma del formato, "CBUFMAP" seguito da '\0'
+    std::uint32_t version; ///< versione del formato
+    std::uint32_t element_size; ///< sizeof degli elementi
+    std::uint32_t capacity; ///< capacità effettiva della coda
+    std::uint32_t checksum; ///< FNV-1a dei campi precedenti
+    std::uint64_t cursor; ///< contatore della testa (32 bit bassi) e numero di elementi (32 bit alti)
+};
+
+/**
+ * @brief Classe mapped_cbuffer
+ *
+ * La classe implementa una coda circolare con sovrascrittura (come
+ * cbuffer) il cui contenuto vive in un file mappato in memoria con mmap.
+ * Ogni operazione è una scrittura nella memoria mappata: non ci sono
+ * chiamate di sistema dopo l'apertura e il sistema operativo riporta le
+ * pagine modificate sul file anche se il processo termina. Riaprendo il
+ * file la coda si ritrova com'era, in O(1) e senza leggere i dati.
+ *
+ * flush() forza la scrittura su disco (msync) per sopravvivere anche a
+ * un crash del sistema operativo o a una caduta di tensione.
+ *
+ * Il file contiene gli elementi byte per byte, quindi T deve essere
+ * banalmente copiabile e il file è leggibile solo su macchine con la
+ * stessa rappresentazione di T (endianness, padding).
+ *
+ * @tparam T Tipo banalmente copiabile degli elementi
+ * @tparam Index Politica di indicizzazione (modulo_index o pow2_index)
+ */
+template<typename T, typename Index = modulo_index> class mapped_cbuffer{
+
+    static_assert(std::is_trivially_copyable<T>::value, "mapped_cbuffer requires a trivially copyable type");
+    static_assert(alignof(T) <= alignof(mapped_cbuffer_header), "mapped_cbuffer requires an alignment of at most 64 bytes");
+
+    static const std::uint32_t format_version = 1; ///< versione del formato scritta nei file nuovi
+
+    int _fd; ///< descrittore del file (-1 se non aperto)
+    void *_map; ///< inizio della memoria mappata
+    std::size_t _bytes; ///< dimensione della memoria mappata
+    mapped_cbuffer_header *_header; ///< intestazione nella memoria mappata
+    T *_queue; ///< dati nella memoria mappata
+    unsigned int _head; ///< contatore della testa (copia di quello nell'intestazione)
+    unsigned int _size; ///< dimensione massima della coda
+    unsigned int _stored_elements; ///< numero di elementi salvati (copia di quello nell'intestazione)
+
+    /**
+     * @brief Funzione di supporto che calcola il checksum dei campi di formato
+     *
+     * @param header intestazione
+     * @return std::uint32_t FNV-1a dei byte che precedono il campo checksum
+     */
+    static std::uint32_t checksum(const mapped_cbuffer_header &header){
+        const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&header);
+        std::uint32_t hash = 2166136261u;
+        for(std::size_t i = 0; i < offsetof(mapped_cbuffer_header, checksum); ++i)
+            hash = (hash ^ bytes[i]) * 16777619u;
+        return hash;
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna la dimensione del file per capacity elementi
+     *
+     * @param capacity capacità della coda
+     * @return std::size_t dimensione in byte
+     */
+    static std::size_t file_size(unsigned int capacity){
+        return sizeof(mapped_cbuffer_header) + sizeof(T) * static_cast<std::size_t>(capacity);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::system_error con errno
+     *
+     * @param what operazione fallita
+     * @throw std::system_error sempre
+     */
+    [[noreturn]] static void throw_system(const std::string &what){
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna la posizione nell'array
+     * dell'elemento a distanza offset dalla testa
+     *
+     * @param offset distanza dalla testa
+     * @return unsigned int posizione nell'array
+     */
+    unsigned int slot(unsigned int offset) const{
+        return Index::slot(_head + offset, _size);
+    }
+
+    /**
+     * @brief Funzione di supporto che scrive testa e numero di elementi
+     * nell'intestazione con un'unica scrittura, dopo i dati
+     *
+     */
+    void publish(){
+        std::uint64_t cursor = _head | (static_cast<std::uint64_t>(_stored_elements) << 32);
+        __atomic_store_n(&_header->cursor, cursor, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief Funzione di supporto che rilascia la mappatura e il descrittore
+     *
+     */
+    void release(){
+        if(_map != nullptr)
+            munmap(_map, _bytes);
+        if(_fd >= 0)
+            close(_fd);
+        _fd = -1;
+        _map = nullptr;
+    }
+
+    /**
+     * @brief Funzione di supporto che apre e mappa il file path. Un file
+     * vuoto (o appena creato) viene inizializzato con capacità
+     * Index::capacity(size); un file esistente deve avere la stessa
+     * capacità, oppure qualsiasi capacità se size è negativo.
+     *
+     * @param path percorso del file
+     * @param create true per creare il file se non esiste
+     * @param size capacità richiesta (negativa per accettare quella del file)
+     * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo
+     * @throw invalid_file_exception eccezione lanciata in caso di file non valido
+     */
+    void map_file(const std::string &path, bool create, int size){
+        _fd = ::open(path.c_str(), create ? O_RDWR | O_CREAT : O_RDWR, 0644);
+        if(_fd < 0)
+            throw_system("Cannot open " + path);
+        struct stat st;
+        if(fstat(_fd, &st) != 0)
+            throw_system("Cannot stat " + path);
+
+        bool fresh = st.st_size == 0 && size >= 0;
+        if(fresh){
+            _size = Index::capacity(size);
+            if(ftruncate(_fd, file_size(_size)) != 0)
+                throw_system("Cannot resize " + path);
+            _bytes = file_size(_size);
+        }else{
+            if(static_cast<std::size_t>(st.st_size) < sizeof(mapped_cbuffer_header))
+                throw invalid_file_exception("The file " + path + " has no mapped_cbuffer header");
+            _bytes = st.st_size;
+        }
+        _map = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if(_map == MAP_FAILED){
+            _map = nullptr;
+            throw_system("Cannot map " + path);
+        }
+        _header = static_cast<mapped_cbuffer_header*>(_map);
+        _queue = reinterpret_cast<T*>(static_cast<char*>(_map) + sizeof(mapped_cbuffer_header));
+
+        if(fresh){
+            std::memcpy(_header->magic, "CBUFMAP", 8);
+            _header->version = format_version;
+            _header->element_size = sizeof(T);
+            _header->capacity = _size;
+            _header->checksum = checksum(*_header);
+            _head = 0;
+            _stored_elements = 0;
+            publish();
+            return;
+        }
+
+        const mapped_cbuffer_header &h = *_header;
+        if(std::memcmp(h.magic, "CBUFMAP", 8) != 0 || h.checksum != checksum(h))
+            throw invalid_file_exception("The file " + path + " has a corrupted mapped_cbuffer header");
+        if(h.version != format_version)
+            throw invalid_file_exception("The file " + path + " has an unsupported mapped_cbuffer version");
+        if(h.element_size != sizeof(T))
+            throw invalid_file_exception("The file " + path + " stores elements of a different size");
+        if(size >= 0 && h.capacity != Index::capacity(size))
+            throw invalid_file_exception("The file " + path + " stores a mapped_cbuffer of a different capacity");
+        if(Index::capacity(h.capacity) != h.capacity) // ad esempio capacità 5 (modulo_index) letta con pow2_index
+            throw invalid_file_exception("The file " + path + " stores a capacity not supported by the index policy");
+        std::uint64_t cursor = __atomic_load_n(&h.cursor, __ATOMIC_ACQUIRE);
+        _size = h.capacity;
+        _stored_elements = static_cast<unsigned int>(cursor >> 32);
+        if(_bytes != file_size(_size) || _stored_elements > _size)
+            throw invalid_file_exception("The file " + path + " has an inconsistent size");
+        // il contatore viene ridotto in [0, size): valido per entrambe le politiche
+        _head = _size == 0 ? 0 : static_cast<unsigned int>(cursor) % _size;
+    }
+
+    /**
+     * @brief Funzione di supporto che apre il file in modo sicuro rispetto
+     * alle eccezioni (il distruttore non viene chiamato se il costruttore lancia)
+     *
+     * @param path percorso del file
+     * @param create true per creare il file se non esiste
+     * @param size capacità richiesta (negativa per accettare quella del file)
+     */
+    void open_file(const std::string &path, bool create, int size){
+        try{
+            map_file(path, create, size);
+        }catch(...){
+            release();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia empty_queue_exception
+     *
+     * @param message stringa contenente il messaggio
+     * @throw empty_queue_exception sempre
+     */
+    [[noreturn]] static void throw_empty(const char *message){
+        throw empty_queue_exception(message);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::out_of_range per operator[]
+     *
+     * @throw std::out_of_range sempre
+     */
+    [[noreturn]] static void throw_out_of_range(){
+        throw std::out_of_range("Cannot call the operator[] due to an index out of bound");
+    }
+
+    public:
+        /**
+         * @brief Costruttore secondario che apre il file path, creandolo
+         * se non esiste o è vuoto. Un file esistente viene ripristinato
+         * così com'era e deve contenere una coda di elementi della stessa
+         * dimensione e con la stessa capacità.
+         *
+         * @param path percorso del file
+         * @param size dimensione massima della coda
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw invalid_file_exception eccezione lanciata in caso di file non valido o incompatibile
+         * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo
+         */
+        mapped_cbuffer(const std::string &path, int size)
+            : _fd(-1), _map(nullptr), _bytes(0), _header(nullptr), _queue(nullptr),
+            _head(0), _size(0), _stored_elements(0){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a cbuffer with a negative size");
+            open_file(path, true, size);
+        }
+
+        /**
+         * @brief Costruttore secondario che apre un file esistente, con
+         * la capacità salvata nel file
+         *
+         * @param path percorso del file
+         * @throw invalid_file_exception eccezione lanciata in caso di file non valido o incompatibile
+         * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo (anche file inesistente)
+         */
+        explicit mapped_cbuffer(const std::string &path)
+            : _fd(-1), _map(nullptr), _bytes(0), _header(nullptr), _queue(nullptr),
+            _head(0), _size(0), _stored_elements(0){
+            open_file(path, false, -1);
+        }
+
+        mapped_cbuffer(const mapped_cbuffer &other) = delete;
+        mapped_cbuffer& operator=(const mapped_cbuffer &other) = delete;
+
+        /**
+         * @brief Move constructor: la mappatura passa a this, other
+         * rimane senza file con dimensione 0
+         *
+         * @param other mapped_cbuffer da spostare
+         */
+        mapped_cbuffer(mapped_cbuffer &&other) noexcept
+            : _fd(other._fd), _map(other._map), _bytes(other._bytes), _header(other._header),
+            _queue(other._queue), _head(other._head), _size(other._size), _stored_elements(other._stored_elements){
+            other._fd = -1;
+            other._map = nullptr;
+            other._bytes = 0;
+            other._header = nullptr;
+            other._queue = nullptr;
+            other._head = 0;
+            other._size = 0;
+            other._stored_elements = 0;
+        }
+
+        /**
+         * @brief Move assignment: la mappatura di this viene rilasciata e
+         * sostituita da quella di other
+         *
+         * @param other mapped_cbuffer da spostare
+         * @return mapped_cbuffer& reference a this
+         */
+        mapped_cbuffer& operator=(mapped_cbuffer &&other) noexcept{
+            if(this != &other){
+                mapped_cbuffer tmp(std::move(other));
+                std::swap(_fd, tmp._fd);
+                std::swap(_map, tmp._map);
+                std::swap(_bytes, tmp._bytes);
+                std::swap(_header, tmp._header);
+                std::swap(_queue, tmp._queue);
+                std::swap(_head, tmp._head);
+                std::swap(_size, tmp._size);
+                std::swap(_stored_elements, tmp._stored_elements);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Distruttore: rilascia la mappatura senza attendere la
+         * scrittura su disco (le modifiche restano nel file)
+         *
+         */
+        ~mapped_cbuffer(){
+            release();
+        }
+
+        /**
+         * @brief Funzione che accoda value. Se la coda è piena il valore
+         * più vecchio viene sovrascritto: la sua rimozione viene pubblicata
+         * prima di riscriverne lo slot, così il cursore nel file non indica
+         * mai un elemento già sovrascritto.
+         *
+         * @param value valore da inserire
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+         */
+        void enqueue(const T &value){
+            if(_size == 0)
+                throw_empty("Cannot add an element in an empty queue");
+            if(is_full()){
+                // prima viene pubblicata la rimozione del più vecchio, poi il suo slot viene riscritto
+                _head = Index::advance(_head, 1, _size);
+                --_stored_elements;
+                publish();
+                _queue[slot(_stored_elements)] = value;
+                ++_stored_elements;
+            }else{
+                _queue[slot(_stored_elements)] = value;
+                ++_stored_elements;
+            }
+            publish();
+        }
+
+        /**
+         * @brief Funzione che rimuove e ritorna l'elemento in testa
+         *
+         * @return T elemento rimosso
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione da una coda vuota
+         */
+        T pop(){
+            if(is_empty())
+                throw_empty("Cannot remove an element from an empty queue");
+            T value = _queue[slot(0)];
+            _head = Index::advance(_head, 1, _size);
+            --_stored_elements;
+            publish();
+            return value;
+        }
+
+        /**
+         * @brief Funzione che svuota la coda
+         *
+         */
+        void clear(){
+            _head = 0;
+            _stored_elements = 0;
+            if(_header != nullptr)
+                publish();
+        }
+
+        /**
+         * @brief Funzione che forza la scrittura su disco delle modifiche
+         *
+         * @param wait true per attendere il completamento (MS_SYNC),
+         * false per avviarla soltanto (MS_ASYNC)
+         * @throw std::system_error eccezione lanciata in caso di errore di msync
+         */
+        void flush(bool wait = true){
+            if(_map != nullptr && msync(_map, _bytes, wait ? MS_SYNC : MS_ASYNC) != 0)
+                throw_system("Cannot flush the mapped_cbuffer");
+        }
+
+        /**
+         * @brief Funzione che ritorna l'elemento in testa
+         *
+         * @return T& riferimento all'elemento in testa (nella memoria mappata)
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        T& head(){
+            if(is_empty())
+                throw_empty("Cannot get the head from an empty queue");
+            return _queue[slot(0)];
+        }
+
+        /**
+         * @brief Funzione che ritorna l'elemento in testa
+         *
+         * @return const T& riferimento all'elemento in testa
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        const T& head() const{
+            if(is_empty())
+                throw_empty("Cannot get the head from an empty queue");
+            return _queue[slot(0)];
+        }
+
+        /**
+         * @brief Funzione che ritorna l'ultimo elemento inserito
+         *
+         * @return T& riferimento all'ultimo elemento (nella memoria mappata)
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        T& tail(){
+            if(is_empty())
+                throw_empty("Cannot get the tail from an empty queue");
+            return _queue[slot(_stored_elements - 1)];
+        }
+
+        /**
+         * @brief Funzione che ritorna l'ultimo elemento inserito
+         *
+         * @return const T& riferimento all'ultimo elemento
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        const T& tail() const{
+            if(is_empty())
+                throw_empty("Cannot get the tail from an empty queue");
+            return _queue[slot(_stored_elements - 1)];
+        }
+
+        /**
+         * @brief Operator[]
+         *
+         * @param index indice (0 è la testa)
+         * @return T& riferimento dell'elemento nella posizione index
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
+         */
+        T& operator[](int index){
+            if(index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
+            return _queue[slot(index)];
+        }
+
+        /**
+         * @brief Operator[] const
+         *
+         * @param index indice (0 è la testa)
+         * @return const T& riferimento dell'elemento nella posizione index
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
+         */
+        const T& operator[](int index) const{
+            if(index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
+            return _queue[slot(index)];
+        }
+
+        typedef std::pair<const T*, unsigned int> const_array_range; ///< segmento contiguo costante (puntatore, lunghezza)
+
+        /**
+         * @brief Funzione che ritorna il primo segmento contiguo dei dati:
+         * dalla testa fino alla fine dell'array (o fino alla coda se la
+         * coda non è circolare)
+         *
+         * @return const_array_range puntatore alla testa e numero di elementi del segmento
+         */
+        const_array_range array_one() const{
+            if(is_empty())
+                return const_array_range(_queue, 0);
+            unsigned int start = slot(0);
+            return const_array_range(_queue + start, std::min(_stored_elements, _size - start));
+        }
+
+        /**
+         * @brief Funzione che ritorna il secondo segmento contiguo dei dati:
+         * dall'inizio dell'array fino alla coda. Il segmento è vuoto
+         * se la coda non è circolare.
+         *
+         * @return const_array_range puntatore all'inizio dell'array e numero di elementi del segmento
+         */
+        const_array_range array_two() const{
+            return const_array_range(_queue, _stored_elements - array_one().second);
+        }
+
+        /**
+         * @brief Funzione che ritorna la dimensione massima della coda
+         *
+         * @return unsigned int dimensione massima
+         */
+        unsigned int size() const{
+            return _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di elementi nella coda
+         *
+         * @return unsigned int numero di elementi
+         */
+        unsigned int stored_elements() const{
+            return _stored_elements;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è vuota
+         *
+         * @return true se la coda è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return _stored_elements == 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è piena
+         *
+         * @return true se la coda è piena
+         * @return false altrimenti
+         */
+        bool is_full() const{
+            return _stored_elements == _size;
+        }
+};
+
+#endif
@@ -0,0 +1,566 @@
+#ifndef MIRRORED_CBUFFER_H
+#define MIRRORED_CBUFFER_H
+#include <algorithm> // std::min
+#include <cerrno>
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+#include <stdexcept> // std::out_of_range
+#include <system_error>
+#include <type_traits> // std::is_same, std::is_trivially_copyable
+#include <utility> // std::pair, std::swap
+#include <sys/mman.h>
+#include <unistd.h>
+#include "negative_queue_size_exception.h"
+#include "empty_queue_exception.h"
+#include "cbuffer_overflow.h"
+/**
+ * @brief Classe mirrored_cbuffer
+ *
+ * La classe implementa una coda circolare in cui l'array è mappato due
+ * volte in memoria virtuale, una copia subito dopo l'altra (memfd_create
+ * più due mmap delle stesse pagine fisiche). L'elemento in posizione
+ * size() + i è lo stesso elemento in posizione i, quindi i dati a partire
+ * dalla testa sono sempre un unico intervallo contiguo di puntatori,
+ * anche quando la coda è circolare: operator[] è un accesso diretto senza
+ * modulo, gli iteratori sono puntatori semplici e le copie in blocco
+ * (enqueue_range, dequeue_into) sono un solo memcpy.
+ *
+ * La capacità viene arrotondata in modo che l'array occupi un numero
+ * intero di pagine. Gli elementi sono copiati con memcpy, quindi T deve
+ * essere banalmente copiabile. Disponibile solo su Linux.
+ *
+ * @tparam T Tipo banalmente copiabile degli elementi
+ * @tparam Overflow Politica di inserimento su coda piena (overwrite_on_full o reject_on_full)
+ */
+template<typename T, typename Overflow = overwrite_on_full> class mirrored_cbuffer{
+
+    static_assert(std::is_trivially_copyable<T>::value, "mirrored_cbuffer requires a trivially copyable type");
+    static_assert(!std::is_same<Overflow, block_on_full>::value,
+        "block_on_full is only supported by the concurrent queues (spsc_cbuffer, mpmc_cbuffer)");
+    static_assert(!std::is_same<Overflow, grow_on_full>::value,
+        "grow_on_full is only supported by cbuffer");
+
+    static const bool rejects = std::is_same<Overflow, reject_on_full>::value; ///< true se la coda piena rifiuta gli inserimenti
+
+    unsigned int _head; ///< posizione della testa, sempre in [0, size)
+    unsigned int _size; ///< dimensione massima della coda
+    unsigned int _stored_elements; ///< numero di elementi salvati
+    T *_queue; ///< inizio della prima delle due mappature (nullptr se size pari a 0)
+
+    /**
+     * @brief Funzione di supporto che ritorna la capacità effettiva: il più
+     * piccolo multiplo di elementi >= size che occupa un numero intero di pagine
+     *
+     * @param size capacità richiesta
+     * @return unsigned int capacità effettiva (0 se size == 0)
+     */
+    static unsigned int capacity(unsigned int size){
+        std::size_t page = sysconf(_SC_PAGESIZE);
+        std::size_t a = page, b = sizeof(T);
+        while(b != 0){ // massimo comun divisore
+            std::size_t r = a % b;
+            a = b;
+            b = r;
+        }
+        std::size_t unit = page / a; // elementi per un multiplo di pagina
+        return static_cast<unsigned int>((size + unit - 1) / unit * unit);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::system_error con errno
+     *
+     * @param what operazione fallita
+     * @throw std::system_error sempre
+     */
+    [[noreturn]] static void throw_system(const char *what){
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    /**
+     * @brief Funzione di supporto che alloca l'array di n elementi mappato
+     * due volte: riserva 2 * n elementi di spazio virtuale e vi mappa due
+     * volte lo stesso file anonimo in memoria
+     *
+     * @param n numero di elementi (la dimensione in byte è un multiplo della pagina)
+     * @return T* inizio della prima mappatura
+     * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo
+     */
+    static T* allocate(unsigned int n){
+        std::size_t bytes = sizeof(T) * static_cast<std::size_t>(n);
+        int fd = memfd_create("mirrored_cbuffer", MFD_CLOEXEC);
+        if(fd < 0)
+            throw_system("Cannot create the mirrored_cbuffer memory file");
+        if(ftruncate(fd, bytes) != 0){
+            int error = errno;
+            close(fd);
+            errno = error;
+            throw_system("Cannot resize the mirrored_cbuffer memory file");
+        }
+        void *area = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(area == MAP_FAILED){
+            int error = errno;
+            close(fd);
+            errno = error;
+            throw_system("Cannot reserve the mirrored_cbuffer address space");
+        }
+        char *base = static_cast<char*>(area);
+        if(mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+            || mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED){
+            int error = errno;
+            munmap(area, 2 * bytes);
+            close(fd);
+            errno = error;
+            throw_system("Cannot map the mirrored_cbuffer memory file");
+        }
+        close(fd); // le mappature tengono in vita il file
+        return reinterpret_cast<T*>(base);
+    }
+
+    /**
+     * @brief Funzione di supporto che rilascia l'array allocato con allocate
+     *
+     * @param p inizio della prima mappatura
+     * @param n numero di elementi
+     */
+    static void deallocate(T *p, unsigned int n){
+        if(p != nullptr)
+            munmap(p, 2 * sizeof(T) * static_cast<std::size_t>(n));
+    }
+
+    /**
+     * @brief Funzione di supporto che sposta in avanti la testa di n posizioni
+     *
+     * @param n numero di posizioni (<= size)
+     */
+    void advance(unsigned int n){
+        _head += n;
+        if(_head >= _size)
+            _head -= _size;
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::out_of_range per operator[]
+     *
+     * @throw std::out_of_range sempre
+     */
+    [[noreturn]] static void throw_out_of_range(){
+        throw std::out_of_range("Cannot call the operator[] due to an index out of bound");
+    }
+
+    public:
+        typedef T* iterator; ///< iteratore ad accesso casuale (puntatore nella mappatura)
+        typedef const T* const_iterator; ///< iteratore costante ad accesso casuale
+
+        /**
+         * @brief Costruttore di default
+         *
+         * @post stored_elements() == 0 e size() == 0
+         */
+        mirrored_cbuffer(): _head(0), _size(0), _stored_elements(0), _queue(nullptr){}
+
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param size dimensione minima della coda (arrotondata a un multiplo della pagina)
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo
+         */
+        explicit mirrored_cbuffer(int size): _head(0), _size(0), _stored_elements(0), _queue(nullptr){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a cbuffer with a negative size");
+            if(size > 0){
+                _queue = allocate(capacity(size));
+                _size = capacity(size);
+            }
+        }
+
+        /**
+         * @brief Copy constructor: la copia ha la stessa capacità e la testa
+         * all'inizio dell'array
+         *
+         * @param other coda da copiare
+         * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo
+         */
+        mirrored_cbuffer(const mirrored_cbuffer &other): _head(0), _size(0), _stored_elements(0), _queue(nullptr){
+            if(other._size > 0){
+                _queue = allocate(other._size);
+                _size = other._size;
+                std::memcpy(_queue, other.begin(), sizeof(T) * other._stored_elements);
+                _stored_elements = other._stored_elements;
+            }
+        }
+
+        /**
+         * @brief Move constructor: other rimane vuota con dimensione 0
+         *
+         * @param other coda da spostare
+         */
+        mirrored_cbuffer(mirrored_cbuffer &&other) noexcept
+            : _head(other._head), _size(other._size), _stored_elements(other._stored_elements), _queue(other._queue){
+            other._head = 0;
+            other._size = 0;
+            other._stored_elements = 0;
+            other._queue = nullptr;
+        }
+
+        /**
+         * @brief Operatore di assegnamento (copy and swap)
+         *
+         * @param other coda da copiare
+         * @return mirrored_cbuffer& reference a this
+         */
+        mirrored_cbuffer& operator=(const mirrored_cbuffer &other){
+            if(this != &other){
+                mirrored_cbuffer tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment
+         *
+         * @param other coda da spostare
+         * @return mirrored_cbuffer& reference a this
+         */
+        mirrored_cbuffer& operator=(mirrored_cbuffer &&other) noexcept{
+            if(this != &other){
+                mirrored_cbuffer tmp(std::move(other));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Distruttore
+         *
+         */
+        ~mirrored_cbuffer(){
+            deallocate(_queue, _size);
+        }
+
+        /**
+         * @brief Funzione che scambia il contenuto di this con other
+         *
+         * @param other coda da scambiare
+         */
+        void swap(mirrored_cbuffer &other) noexcept{
+            std::swap(_head, other._head);
+            std::swap(_size, other._size);
+            std::swap(_stored_elements, other._stored_elements);
+            std::swap(_queue, other._queue);
+        }
+
+        /**
+         * @brief Funzione che accoda value. Se la coda è piena il valore più
+         * vecchio viene sovrascritto (overwrite_on_full) oppure value viene
+         * rifiutato (reject_on_full).
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+         */
+        bool enqueue(const T &value){
+            if(_size == 0)
+                throw empty_queue_exception("Cannot add an element in an empty queue");
+            if constexpr (rejects){
+                if(is_full())
+                    return false;
+            }
+            _queue[_head + _stored_elements] = value; // head + stored < 2 * size: sempre nella mappatura
+            if(is_full())
+                advance(1);
+            else
+                ++_stored_elements;
+            return true;
+        }
+
+        /**
+         * @brief Funzione che rimuove e ritorna l'elemento in testa
+         *
+         * @return T elemento rimosso
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione da una coda vuota
+         */
+        T pop(){
+            if(is_empty())
+                throw empty_queue_exception("Cannot remove an element from an empty queue");
+            T value = _queue[_head];
+            advance(1);
+            --_stored_elements;
+            return value;
+        }
+
+        /**
+         * @brief Funzione che accoda gli elementi di [first, last) con un solo
+         * memcpy. Se la sequenza non entra nello spazio libero, con
+         * overwrite_on_full vengono sovrascritti gli elementi più vecchi (se è
+         * più lunga della capacità restano solo gli ultimi size() elementi),
+         * con reject_on_full vengono inseriti solo i primi elementi che entrano.
+         *
+         * @param first puntatore di inizio
+         * @param last puntatore di fine
+         * @return unsigned int numero di elementi della sequenza accodati
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una coda con size pari a 0
+         */
+        unsigned int enqueue_range(const T *first, const T *last){
+            unsigned int n = static_cast<unsigned int>(last - first);
+            if(n == 0)
+                return 0;
+            if(_size == 0)
+                throw empty_queue_exception("Cannot add an element in an empty queue");
+            unsigned int accepted = n;
+            if constexpr (rejects)
+                accepted = n = std::min(n, _size - _stored_elements);
+            else{
+                if(n > _size){ // restano solo gli ultimi _size elementi
+                    first = last - _size;
+                    n = _size;
+                }
+                if(_stored_elements + n > _size){ // coda piena: scarto i più vecchi
+                    unsigned int dropped = _stored_elements + n - _size;
+                    advance(dropped);
+                    _stored_elements -= dropped;
+                }
+            }
+            std::memcpy(_queue + _head + _stored_elements, first, sizeof(T) * n);
+            _stored_elements += n;
+            return accepted;
+        }
+
+        /**
+         * @brief Funzione che rimuove fino a n elementi dalla testa copiandoli
+         * in out con un solo memcpy
+         *
+         * @param out inizio dell'array di output (almeno n elementi)
+         * @param n numero massimo di elementi da rimuovere
+         * @return unsigned int numero di elementi effettivamente rimossi
+         */
+        unsigned int dequeue_into(T *out, unsigned int n){
+            n = std::min(n, _stored_elements);
+            if(n > 0)
+                std::memcpy(out, _queue + _head, sizeof(T) * n);
+            advance(n);
+            _stored_elements -= n;
+            return n;
+        }
+
+        /**
+         * @brief Funzione che svuota la coda
+         *
+         */
+        void clear(){
+            _head = 0;
+            _stored_elements = 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna l'elemento in testa
+         *
+         * @return T& riferimento all'elemento in testa
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        T& head(){
+            if(is_empty())
+                throw empty_queue_exception("Cannot get the head from an empty queue");
+            return _queue[_head];
+        }
+
+        /**
+         * @brief Funzione che ritorna l'elemento in testa
+         *
+         * @return const T& riferimento all'elemento in testa
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        const T& head() const{
+            if(is_empty())
+                throw empty_queue_exception("Cannot get the head from an empty queue");
+            return _queue[_head];
+        }
+
+        /**
+         * @brief Funzione che ritorna l'ultimo elemento inserito
+         *
+         * @return T& riferimento all'ultimo elemento
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        T& tail(){
+            if(is_empty())
+                throw empty_queue_exception("Cannot get the tail from an empty queue");
+            return _queue[_head + _stored_elements - 1];
+        }
+
+        /**
+         * @brief Funzione che ritorna l'ultimo elemento inserito
+         *
+         * @return const T& riferimento all'ultimo elemento
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        const T& tail() const{
+            if(is_empty())
+                throw empty_queue_exception("Cannot get the tail from an empty queue");
+            return _queue[_head + _stored_elements - 1];
+        }
+
+        /**
+         * @brief Operator[]: accesso diretto senza modulo
+         *
+         * @param index indice (0 è la testa)
+         * @return T& riferimento dell'elemento nella posizione index
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
+         */
+        T& operator[](int index){
+            if(index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
+            return _queue[_head + index];
+        }
+
+        /**
+         * @brief Operator[] const: accesso diretto senza modulo
+         *
+         * @param index indice (0 è la testa)
+         * @return const T& riferimento dell'elemento nella posizione index
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
+         */
+        const T& operator[](int index) const{
+            if(index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
+            return _queue[_head + index];
+        }
+
+        /**
+         * @brief Funzione che ritorna il puntatore alla testa: gli elementi
+         * sono contigui in [data(), data() + stored_elements())
+         *
+         * @return T* puntatore alla testa (nullptr se size pari a 0)
+         */
+        T* data(){
+            return _queue == nullptr ? nullptr : _queue + _head;
+        }
+
+        /**
+         * @brief Funzione che ritorna il puntatore alla testa
+         *
+         * @return const T* puntatore alla testa (nullptr se size pari a 0)
+         */
+        const T* data() const{
+            return _queue == nullptr ? nullptr : _queue + _head;
+        }
+
+        /**
+         * @brief Funzione che ritorna l'iteratore alla testa
+         *
+         * @return iterator puntatore alla testa
+         */
+        iterator begin(){
+            return data();
+        }
+
+        /**
+         * @brief Funzione che ritorna l'iteratore dopo l'ultimo elemento
+         *
+         * @return iterator puntatore dopo l'ultimo elemento
+         */
+        iterator end(){
+            return data() + _stored_elements;
+        }
+
+        /**
+         * @brief Funzione che ritorna l'iteratore costante alla testa
+         *
+         * @return const_iterator puntatore alla testa
+         */
+        const_iterator begin() const{
+            return data();
+        }
+
+        /**
+         * @brief Funzione che ritorna l'iteratore costante dopo l'ultimo elemento
+         *
+         * @return const_iterator puntatore dopo l'ultimo elemento
+         */
+        const_iterator end() const{
+            return data() + _stored_elements;
+        }
+
+        typedef std::pair<T*, unsigned int> array_range; ///< segmento contiguo (puntatore, lunghezza)
+        typedef std::pair<const T*, unsigned int> const_array_range; ///< segmento contiguo costante (puntatore, lunghezza)
+
+        /**
+         * @brief Funzione che ritorna il segmento contiguo dei dati: con la
+         * doppia mappatura contiene sempre tutti gli elementi
+         *
+         * @return array_range puntatore alla testa e numero di elementi salvati
+         */
+        array_range array_one(){
+            return array_range(data(), _stored_elements);
+        }
+
+        /**
+         * @brief Funzione che ritorna il segmento contiguo dei dati
+         *
+         * @return const_array_range puntatore alla testa e numero di elementi salvati
+         */
+        const_array_range array_one() const{
+            return const_array_range(data(), _stored_elements);
+        }
+
+        /**
+         * @brief Funzione che ritorna il secondo segmento, sempre vuoto
+         * (presente per compatibilità con cbuffer)
+         *
+         * @return array_range segmento vuoto
+         */
+        array_range array_two(){
+            return array_range(_queue, 0);
+        }
+
+        /**
+         * @brief Funzione che ritorna il secondo segmento, sempre vuoto
+         *
+         * @return const_array_range segmento vuoto
+         */
+        const_array_range array_two() const{
+            return const_array_range(_queue, 0);
+        }
+
+        /**
+         * @brief Funzione che ritorna la dimensione massima della coda
+         *
+         * @return unsigned int dimensione massima
+         */
+        unsigned int size() const{
+            return _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di elementi nella coda
+         *
+         * @return unsigned int numero di elementi
+         */
+        unsigned int stored_elements() const{
+            return _stored_elements;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è vuota
+         *
+         * @return true se la coda è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return _stored_elements == 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è piena
+         *
+         * @return true se la coda è piena
+         * @return false altrimenti
+         */
+        bool is_full() const{
+            return _stored_elements == _size;
+        }
+};
+
+#endif
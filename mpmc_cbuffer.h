@@ -0,0 +1,259 @@
+#ifndef MPMC_CBUFFER_H
+#define MPMC_CBUFFER_H
+#include <atomic>
+#include <thread> // std::this_thread::yield
+#include <type_traits> // std::is_same
+#include <new> // placement new, std::align_val_t
+#include <utility> // std::move, std::forward
+#include "negative_queue_size_exception.h"
+#include "cbuffer_index.h"
+#include "cbuffer_overflow.h"
+#include "cache_line.h"
+/**
+ * @brief Classe mpmc_cbuffer
+ *
+ * La classe implementa una coda circolare a capacità fissa, lock-free,
+ * per più thread produttori e più thread consumatori (algoritmo di
+ * D. Vyukov con numero di sequenza per slot).
+ *
+ * Ogni slot contiene un numero di sequenza che indica chi può usarlo:
+ * - sequenza == pos: lo slot è libero per l'inserimento in posizione pos
+ * - sequenza == pos + 1: lo slot contiene l'elemento inserito in posizione pos
+ * I contatori di inserimento e rimozione sono contesi con una
+ * compare-and-swap e stanno su linee di cache diverse.
+ * Come spsc_cbuffer, quando la coda è piena try_enqueue fallisce mentre
+ * enqueue si comporta secondo la politica Overflow.
+ *
+ * @tparam T Tipo degli elementi contenuti nella coda
+ * @tparam Overflow Politica di inserimento su coda piena (reject_on_full o block_on_full)
+ */
+template<typename T, typename Overflow = reject_on_full> class mpmc_cbuffer{
+
+    static_assert(!std::is_same<Overflow, overwrite_on_full>::value,
+        "overwrite_on_full is not supported: the producer cannot destroy an element the consumer may be reading");
+    static_assert(!std::is_same<Overflow, grow_on_full>::value,
+        "grow_on_full is only supported by cbuffer");
+
+    /**
+     * @brief Slot della coda: numero di sequenza e memoria
+     * non inizializzata per un elemento
+     */
+    struct cell{
+        std::atomic<unsigned int> sequence; ///< numero di sequenza dello slot
+        alignas(T) unsigned char storage[sizeof(T)]; ///< memoria per l'elemento
+
+        /**
+         * @brief Funzione che ritorna il puntatore all'elemento nello slot
+         *
+         * @return T* puntatore all'elemento
+         */
+        T* value(){
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+    alignas(CBUFFER_CACHE_LINE) std::atomic<unsigned int> _enqueue_pos; ///< contatore dei produttori
+    alignas(CBUFFER_CACHE_LINE) std::atomic<unsigned int> _dequeue_pos; ///< contatore dei consumatori
+    alignas(CBUFFER_CACHE_LINE) unsigned int _size; ///< dimensione massima della coda
+    cell *_cells; ///< array degli slot
+
+    public:
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param size dimensione massima della coda (arrotondata a una potenza di due, almeno 2)
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione dell'array non riuscita
+         */
+        explicit mpmc_cbuffer(int size): _enqueue_pos(0), _dequeue_pos(0), _size(0), _cells(nullptr){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a mpmc_cbuffer with a negative size");
+            if(size == 1) // con un solo slot le sequenze "libero" e "pieno" coincidono
+                size = 2;
+            _size = pow2_index::capacity(size);
+            _cells = static_cast<cell*>(::operator new(sizeof(cell) * _size, std::align_val_t(alignof(cell))));
+            for(unsigned int i = 0; i < _size; ++i)
+                new (&_cells[i].sequence) std::atomic<unsigned int>(i);
+        }
+
+        mpmc_cbuffer(const mpmc_cbuffer &other) = delete;
+        mpmc_cbuffer& operator=(const mpmc_cbuffer &other) = delete;
+
+        /**
+         * @brief Distruttore: distrugge gli elementi non ancora letti.
+         * Nessun thread deve usare la coda durante la distruzione.
+         *
+         */
+        ~mpmc_cbuffer(){
+            unsigned int tail = _enqueue_pos.load(std::memory_order_relaxed);
+            for(unsigned int i = _dequeue_pos.load(std::memory_order_relaxed); i != tail; ++i)
+                _cells[pow2_index::slot(i, _size)].value()->~T();
+            ::operator delete(_cells, std::align_val_t(alignof(cell)));
+        }
+
+        /**
+         * @brief Funzione che costruisce in coda un nuovo elemento a partire
+         * dagli argomenti passati in input. Non prende lock.
+         *
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena
+         */
+        template<typename... Args> bool try_emplace(Args&&... args){
+            if(_size == 0)
+                return false;
+            cell *c;
+            unsigned int pos = _enqueue_pos.load(std::memory_order_relaxed);
+            for(;;){
+                c = &_cells[pow2_index::slot(pos, _size)];
+                unsigned int sequence = c->sequence.load(std::memory_order_acquire);
+                int diff = static_cast<int>(sequence - pos);
+                if(diff == 0){ // slot libero: provo a prenotarlo
+                    if(_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }else if(diff < 0) // lo slot contiene ancora un elemento di un giro precedente
+                    return false;
+                else // un altro produttore ha già preso pos
+                    pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+            new (c->value()) T(std::forward<Args>(args)...);
+            c->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Funzione che costruisce in coda un nuovo elemento.
+         * Se la coda è piena ritorna false (reject_on_full) oppure attende
+         * che si liberi uno slot (block_on_full).
+         *
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        template<typename... Args> bool emplace(Args&&... args){
+            if constexpr (std::is_same<Overflow, block_on_full>::value){
+                if(_size == 0)
+                    return false;
+                // gli argomenti vengono usati solo dal tentativo che riesce
+                while(!try_emplace(std::forward<Args>(args)...))
+                    std::this_thread::yield();
+                return true;
+            }else
+                return try_emplace(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Funzione che accoda una copia di value secondo la politica Overflow
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        bool enqueue(const T &value){
+            return emplace(value);
+        }
+
+        /**
+         * @brief Funzione che accoda value spostandolo secondo la politica Overflow
+         *
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        bool enqueue(T &&value){
+            return emplace(std::move(value));
+        }
+
+        /**
+         * @brief Funzione che accoda una copia di value
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena
+         */
+        bool try_enqueue(const T &value){
+            return try_emplace(value);
+        }
+
+        /**
+         * @brief Funzione che accoda value spostandolo
+         *
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena (value non viene spostato)
+         */
+        bool try_enqueue(T &&value){
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa spostandolo in value.
+         * Non prende lock.
+         *
+         * @param value riferimento in cui spostare l'elemento rimosso
+         * @return true se un elemento è stato rimosso
+         * @return false se la coda è vuota
+         */
+        bool try_dequeue(T &value){
+            if(_size == 0)
+                return false;
+            cell *c;
+            unsigned int pos = _dequeue_pos.load(std::memory_order_relaxed);
+            for(;;){
+                c = &_cells[pow2_index::slot(pos, _size)];
+                unsigned int sequence = c->sequence.load(std::memory_order_acquire);
+                int diff = static_cast<int>(sequence - (pos + 1));
+                if(diff == 0){ // slot pieno: provo a prenotarlo
+                    if(_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }else if(diff < 0) // nessun elemento inserito in pos
+                    return false;
+                else // un altro consumatore ha già preso pos
+                    pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+            T *p = c->value();
+            value = std::move(*p);
+            p->~T();
+            c->sequence.store(pos + _size, std::memory_order_release); // libero per il giro successivo
+            return true;
+        }
+
+        /**
+         * @brief Funzione che ritorna la dimensione massima della coda
+         *
+         * @return unsigned int dimensione della coda
+         */
+        unsigned int size() const{
+            return _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero approssimato di elementi
+         * salvati nella coda (istantanea, può cambiare subito dopo)
+         *
+         * @return unsigned int
+         */
+        unsigned int stored_elements() const{
+            unsigned int head = _dequeue_pos.load(std::memory_order_acquire);
+            unsigned int tail = _enqueue_pos.load(std::memory_order_acquire);
+            int diff = static_cast<int>(tail - head);
+            if(diff <= 0)
+                return 0;
+            return static_cast<unsigned int>(diff) < _size ? static_cast<unsigned int>(diff) : _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda sembra vuota
+         * (istantanea, può cambiare subito dopo)
+         *
+         * @return true se la coda è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return stored_elements() == 0;
+        }
+};
+
+#endif
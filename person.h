@@ -0,0 +1,72 @@
+#ifndef PERSON_H
+#define PERSON_H
+#include <string>
+#include <ostream>
+/**
+ * @brief Struct person che rappresenta una persona.
+ * 
+ *  Struct person che rappresenta una persona.
+ */
+struct person{
+    std::string name;///<  nome della persona
+    std::string surname;///< cognome della persona
+
+    /**
+    * @brief Costruttore di default
+    */
+    person(): name(""), surname(""){}
+    /**
+     * @brief Costruttore secondario
+     * 
+     * @param name nome della persona
+     * @param surname cognome della persona
+     */
+    person(const std::string name, const std::string surname)
+        :name(name), surname(surname){}
+    
+    /**
+     * @brief Operatore assegnamento
+     * Necessario per la classe sparsematrix
+     * 
+     * @param other persona
+     * @return reference dell'oggetto persona this
+     */
+    person& operator=(const person &other){
+        name=other.name;
+        surname=other.surname;
+        return *this;
+    } 
+     /**
+     * @brief Ridefinizione dell'operatore di stream << per un point.
+     * Necessario per l'operatore di stream della classe sparsematrix.
+     * 
+     * */
+    friend std::ostream& operator<<(std::ostream &os, const person &p){
+        return os<<"["<<p.name<<","<<p.surname<<"]"; 
+    }
+    /**
+     * @brief Ridefinizione dell'operatore assegnamento
+     * 
+     * @param other reference di un oggetto persona
+     * @return true se i dati membri dell'oggetto this sono uguali a
+     * quelli dell'oggetto other
+     * @return false altrimenti
+     */
+    bool operator==(const person &other) const{
+      return name == other.name && surname == other.surname;
+    }
+
+    /**
+     * @brief Funzione che verifica se il nome della persona
+     * inizia con il carattere passato come parametro
+     * 
+     * @param c carattere iniziale
+     * @return true se il nome inizia con il carattere passato in input
+     * @return false altrimenti
+     */
+    bool name_stars_with(const char &c) const{
+      return name.at(0) == c;
+    }
+};
+
+#endif
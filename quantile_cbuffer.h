@@ -0,0 +1,325 @@
+#ifndef QUANTILE_CBUFFER_H
+#define QUANTILE_CBUFFER_H
+#include <algorithm> // std::fill
+#include <cmath>
+#include <stdexcept> // std::out_of_range
+#include <type_traits> // std::is_arithmetic
+#include <vector>
+#include "cbuffer.h"
+#include "empty_queue_exception.h"
+/**
+ * @brief Suddivisione in intervalli di uguale ampiezza
+ *
+ * L'intervallo [lowest, lowest + width * count) è diviso in count
+ * intervalli di ampiezza width; i valori fuori range finiscono nel
+ * primo o nell'ultimo intervallo. Il valore rappresentativo di un
+ * intervallo è il suo estremo inferiore, quindi per valori multipli
+ * di width (a partire da lowest) i quantili sono esatti.
+ */
+class linear_buckets{
+    double _lowest; ///< estremo inferiore del primo intervallo
+    double _width; ///< ampiezza degli intervalli
+    unsigned int _count; ///< numero di intervalli
+
+    public:
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param lowest estremo inferiore del primo intervallo
+         * @param width ampiezza degli intervalli (> 0)
+         * @param count numero di intervalli (> 0)
+         * @throw std::out_of_range eccezione lanciata se width o count non sono positivi
+         */
+        linear_buckets(double lowest, double width, unsigned int count)
+            : _lowest(lowest), _width(width), _count(count){
+            if(!(width > 0) || count == 0)
+                throw std::out_of_range("linear_buckets requires a positive width and count");
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di intervalli
+         *
+         * @return unsigned int numero di intervalli
+         */
+        unsigned int count() const{
+            return _count;
+        }
+
+        /**
+         * @brief Funzione che ritorna l'intervallo del valore value
+         *
+         * @param value valore
+         * @return unsigned int indice dell'intervallo in [0, count())
+         */
+        unsigned int bucket(double value) const{
+            double b = std::floor((value - _lowest) / _width);
+            if(!(b > 0)) // anche NaN
+                return 0;
+            return b < _count ? static_cast<unsigned int>(b) : _count - 1;
+        }
+
+        /**
+         * @brief Funzione che ritorna il valore rappresentativo dell'intervallo b
+         *
+         * @param b indice dell'intervallo
+         * @return double estremo inferiore dell'intervallo
+         */
+        double value(unsigned int b) const{
+            return _lowest + _width * b;
+        }
+};
+
+/**
+ * @brief Suddivisione in intervalli di ampiezza crescente in modo
+ * geometrico, adatta a latenze e altre grandezze su più ordini di
+ * grandezza
+ *
+ * Tra lowest e highest ogni intervallo è (1 + 2 * relative_error) volte
+ * più largo del precedente e il valore rappresentativo è il centro
+ * dell'intervallo, quindi l'errore relativo di un quantile è al più
+ * relative_error. I valori sotto lowest finiscono nel primo intervallo
+ * (rappresentato da lowest), quelli sopra highest nell'ultimo.
+ */
+class log_buckets{
+    double _lowest; ///< valore minimo distinto
+    double _log_growth; ///< logaritmo del fattore di crescita
+    double _half_width; ///< errore relativo massimo
+    unsigned int _count; ///< numero di intervalli
+
+    public:
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param lowest valore minimo distinto (> 0)
+         * @param highest valore massimo distinto (> lowest)
+         * @param relative_error errore relativo massimo dei quantili (> 0)
+         * @throw std::out_of_range eccezione lanciata in caso di parametri non validi
+         */
+        log_buckets(double lowest, double highest, double relative_error)
+            : _lowest(lowest), _log_growth(std::log1p(2 * relative_error)), _half_width(relative_error), _count(0){
+            if(!(lowest > 0) || !(highest > lowest) || !(relative_error > 0))
+                throw std::out_of_range("log_buckets requires 0 < lowest < highest and a positive relative error");
+            _count = static_cast<unsigned int>(std::ceil(std::log(highest / lowest) / _log_growth)) + 1;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di intervalli
+         *
+         * @return unsigned int numero di intervalli
+         */
+        unsigned int count() const{
+            return _count;
+        }
+
+        /**
+         * @brief Funzione che ritorna l'intervallo del valore value
+         *
+         * @param value valore
+         * @return unsigned int indice dell'intervallo in [0, count())
+         */
+        unsigned int bucket(double value) const{
+            if(!(value > _lowest)) // anche NaN
+                return 0;
+            double b = std::floor(std::log(value / _lowest) / _log_growth) + 1;
+            return b < _count ? static_cast<unsigned int>(b) : _count - 1;
+        }
+
+        /**
+         * @brief Funzione che ritorna il valore rappresentativo dell'intervallo b
+         *
+         * @param b indice dell'intervallo
+         * @return double centro dell'intervallo (lowest per il primo)
+         */
+        double value(unsigned int b) const{
+            if(b == 0)
+                return _lowest;
+            return _lowest * std::exp(_log_growth * (b - 1)) * (1 + _half_width);
+        }
+};
+
+/**
+ * @brief Classe quantile_cbuffer
+ *
+ * La classe implementa una finestra scorrevole sugli ultimi size()
+ * valori (con sovrascrittura come cbuffer) che risponde a richieste di
+ * quantili (p50, p95, p99, ...) sul contenuto corrente.
+ *
+ * I valori sono contati in un istogramma a intervalli definito da
+ * Buckets (linear_buckets o log_buckets) e salvato in un albero di
+ * Fenwick: enqueue incrementa l'intervallo del nuovo valore e decrementa
+ * quello del valore sovrascritto, in O(log count()). Un quantile si
+ * ottiene cercando il primo intervallo con conteggio cumulativo
+ * sufficiente, sempre in O(log count()) e indipendentemente dalla
+ * dimensione della finestra. Il risultato è il valore rappresentativo
+ * dell'intervallo, con l'errore dichiarato dalla politica Buckets.
+ *
+ * Come window_cbuffer, la lunghezza della finestra è quella passata al
+ * costruttore anche quando pow2_index arrotonda la capacità della coda.
+ *
+ * @tparam T Tipo aritmetico dei valori
+ * @tparam Buckets Suddivisione in intervalli (linear_buckets o log_buckets)
+ * @tparam Index Politica di indicizzazione (modulo_index o pow2_index)
+ */
+template<typename T, typename Buckets = log_buckets, typename Index = modulo_index> class quantile_cbuffer{
+
+    static_assert(std::is_arithmetic<T>::value, "quantile_cbuffer requires an arithmetic type");
+
+    cbuffer<T, Index> _window; ///< valori nella finestra
+    Buckets _buckets; ///< suddivisione in intervalli
+    std::vector<unsigned int> _tree; ///< albero di Fenwick dei conteggi (indici da 1)
+    unsigned int _top; ///< potenza di due più grande <= count(), per la ricerca
+    unsigned int _length; ///< numero di valori nella finestra (con pow2_index minore o uguale a _window.size())
+
+    /**
+     * @brief Funzione di supporto che somma delta al conteggio dell'intervallo b
+     *
+     * @param b indice dell'intervallo
+     * @param delta +1 o -1 (come unsigned, in aritmetica modulare)
+     */
+    void update(unsigned int b, unsigned int delta){
+        for(unsigned int i = b + 1; i < _tree.size(); i += i & (0u - i))
+            _tree[i] += delta;
+    }
+
+    public:
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param size numero di valori nella finestra
+         * @param buckets suddivisione in intervalli
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita
+         */
+        quantile_cbuffer(int size, const Buckets &buckets)
+            : _window(size), _buckets(buckets), _tree(buckets.count() + 1, 0), _top(1), _length(size){
+            while(_top * 2 <= _buckets.count())
+                _top *= 2;
+        }
+
+        /**
+         * @brief Funzione che accoda value. Se la finestra è piena il
+         * valore più vecchio esce dalla finestra e viene sovrascritto.
+         *
+         * @param value valore da inserire
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una finestra con size pari a 0
+         */
+        void enqueue(const T &value){
+            if(_length == 0)
+                throw empty_queue_exception("Cannot add an element in an empty queue");
+            if(is_full()){
+                update(_buckets.bucket(_window.head()), 0u - 1u);
+                if(!_window.is_full()) // capacità arrotondata da pow2_index: la testa va rimossa
+                    _window.pop();
+            }
+            _window.enqueue(value); // sovrascrive la testa se la finestra riempie la capacità
+            update(_buckets.bucket(value), 1u);
+        }
+
+        /**
+         * @brief Funzione che rimuove il valore più vecchio della finestra
+         *
+         * @return T valore rimosso
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione da una finestra vuota
+         */
+        T pop(){
+            T value = _window.pop();
+            update(_buckets.bucket(value), 0u - 1u);
+            return value;
+        }
+
+        /**
+         * @brief Funzione che svuota la finestra
+         *
+         */
+        void clear(){
+            _window.clear();
+            std::fill(_tree.begin(), _tree.end(), 0u);
+        }
+
+        /**
+         * @brief Funzione che ritorna il quantile q dei valori nella finestra
+         * (metodo nearest rank: il valore di rango ceil(q * n), almeno 1)
+         *
+         * @param q quantile in [0, 1] (0.5 mediana, 0.99 99-esimo percentile)
+         * @return double valore rappresentativo dell'intervallo del quantile
+         * @throw empty_queue_exception eccezione lanciata nel caso la finestra fosse vuota
+         * @throw std::out_of_range eccezione lanciata se q non è in [0, 1]
+         */
+        double quantile(double q) const{
+            if(!(q >= 0 && q <= 1))
+                throw std::out_of_range("The quantile must be in [0, 1]");
+            if(is_empty())
+                throw empty_queue_exception("Cannot compute a quantile of an empty queue");
+            unsigned int rank = static_cast<unsigned int>(std::ceil(q * _window.stored_elements()));
+            if(rank == 0)
+                rank = 1;
+            // discesa sull'albero: pos è l'ultimo intervallo con conteggio cumulativo < rank
+            unsigned int pos = 0;
+            for(unsigned int step = _top; step > 0; step >>= 1){
+                if(pos + step < _tree.size() && _tree[pos + step] < rank){
+                    pos += step;
+                    rank -= _tree[pos];
+                }
+            }
+            return _buckets.value(pos); // pos + 1 in base 1, cioè l'intervallo pos
+        }
+
+        /**
+         * @brief Funzione che ritorna la suddivisione in intervalli
+         *
+         * @return const Buckets& suddivisione in intervalli
+         */
+        const Buckets& buckets() const{
+            return _buckets;
+        }
+
+        /**
+         * @brief Funzione che ritorna i valori nella finestra (in sola lettura)
+         *
+         * @return const cbuffer<T, Index>& valori dal più vecchio al più recente
+         * (con pow2_index la sua capacità può essere maggiore di size())
+         */
+        const cbuffer<T, Index>& window() const{
+            return _window;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero massimo di valori nella finestra
+         *
+         * @return unsigned int dimensione della finestra
+         */
+        unsigned int size() const{
+            return _length;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di valori nella finestra
+         *
+         * @return unsigned int numero di valori
+         */
+        unsigned int stored_elements() const{
+            return _window.stored_elements();
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la finestra è vuota
+         *
+         * @return true se la finestra è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return _window.is_empty();
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la finestra è piena
+         *
+         * @return true se la finestra è piena
+         * @return false altrimenti
+         */
+        bool is_full() const{
+            return _window.stored_elements() == _length;
+        }
+};
+
+#endif
@@ -0,0 +1,388 @@
+#ifndef RECORD_CBUFFER_H
+#define RECORD_CBUFFER_H
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <new> // std::align_val_t
+#include <stdexcept> // std::logic_error, std::out_of_range
+#include <type_traits> // std::is_same
+#include <utility> // std::pair, std::swap
+#include "negative_queue_size_exception.h"
+#include "empty_queue_exception.h"
+#include "cbuffer_overflow.h"
+/**
+ * @brief Classe record_cbuffer
+ *
+ * La classe implementa una coda circolare di record di lunghezza
+ * variabile salvati in un'unica area di byte: ogni record è preceduto
+ * da un'intestazione di 4 byte con la sua lunghezza ed è allineato a 4
+ * byte, quindi messaggi e righe di log non richiedono un'allocazione
+ * per elemento come cbuffer<std::string>.
+ *
+ * Scrittura senza copie: reserve(n) ritorna un puntatore a n byte
+ * contigui nell'area, commit(m) pubblica il record con i primi m <= n
+ * byte. Lettura senza copie: peek() ritorna il record in testa come
+ * (puntatore, lunghezza), release() lo rimuove.
+ *
+ * Un record non viene mai spezzato: se non entra tra la coda e la fine
+ * dell'area, lo spazio rimanente viene marcato come riempimento (una
+ * intestazione con lunghezza padding_marker) e il record viene scritto
+ * all'inizio dell'area. Il riempimento viene rimosso insieme al record
+ * che lo precede, quindi la testa è sempre un record.
+ *
+ * Con overwrite_on_full reserve scarta i record più vecchi finché il
+ * nuovo non entra; con reject_on_full ritorna nullptr se manca spazio.
+ * In entrambi i casi ritorna nullptr se il record è più grande di
+ * max_record_size().
+ *
+ * @tparam Overflow Politica di inserimento su coda piena (overwrite_on_full o reject_on_full)
+ */
+template<typename Overflow = overwrite_on_full> class record_cbuffer{
+
+    static_assert(!std::is_same<Overflow, block_on_full>::value,
+        "block_on_full is only supported by the concurrent queues (spsc_cbuffer, mpmc_cbuffer)");
+    static_assert(!std::is_same<Overflow, grow_on_full>::value,
+        "grow_on_full is only supported by cbuffer");
+
+    static const bool rejects = std::is_same<Overflow, reject_on_full>::value; ///< true se la coda piena rifiuta gli inserimenti
+    static const std::uint32_t header_size = sizeof(std::uint32_t); ///< dimensione dell'intestazione (e allineamento) dei record
+    static const std::uint32_t padding_marker = 0xFFFFFFFFu; ///< lunghezza che marca il riempimento fino alla fine dell'area
+
+    unsigned char *_arena; ///< area di byte (allineata a 4)
+    unsigned int _size; ///< dimensione dell'area in byte (multiplo di 4)
+    unsigned int _head; ///< posizione in byte del record in testa
+    unsigned int _tail; ///< posizione in byte del prossimo record
+    unsigned int _used; ///< byte occupati, riempimento compreso
+    unsigned int _records; ///< numero di record salvati
+    unsigned int _reserved; ///< byte riservati dall'ultima reserve (0 se nessuna)
+    unsigned int _reserved_at; ///< posizione del record riservato (0 o _tail)
+
+    /**
+     * @brief Funzione di supporto che arrotonda n al multiplo di 4 successivo
+     *
+     * @param n numero di byte
+     * @return unsigned int n arrotondato
+     */
+    static unsigned int align(unsigned int n){
+        return (n + header_size - 1) & ~(header_size - 1);
+    }
+
+    /**
+     * @brief Funzione di supporto che legge l'intestazione in posizione pos
+     *
+     * @param pos posizione in byte
+     * @return std::uint32_t lunghezza del record o padding_marker
+     */
+    std::uint32_t header(unsigned int pos) const{
+        std::uint32_t length;
+        std::memcpy(&length, _arena + pos, header_size);
+        return length;
+    }
+
+    /**
+     * @brief Funzione di supporto che scrive l'intestazione in posizione pos
+     *
+     * @param pos posizione in byte
+     * @param length lunghezza del record o padding_marker
+     */
+    void set_header(unsigned int pos, std::uint32_t length){
+        std::memcpy(_arena + pos, &length, header_size);
+    }
+
+    /**
+     * @brief Funzione di supporto che cerca spazio contiguo per need byte
+     *
+     * @param need byte necessari (intestazione compresa, allineati)
+     * @param at posizione in cui scrivere il record
+     * @return true se lo spazio c'è
+     * @return false altrimenti
+     */
+    bool fits(unsigned int need, unsigned int &at) const{
+        if(_tail > _head || _used == 0){ // spazio libero alla fine e all'inizio
+            if(need <= _size - _tail){
+                at = _tail;
+                return true;
+            }
+            if(need <= _head){
+                at = 0;
+                return true;
+            }
+            return false;
+        }
+        at = _tail; // spazio libero solo tra coda e testa
+        return need <= _head - _tail;
+    }
+
+    /**
+     * @brief Funzione di supporto che rimuove il record in testa
+     * (la coda non deve essere vuota)
+     *
+     */
+    void drop(){
+        unsigned int bytes = align(header_size + header(_head));
+        _head += bytes;
+        if(_head == _size)
+            _head = 0;
+        _used -= bytes;
+        --_records;
+        if(_used == 0) // coda vuota: si riparte dall'inizio, lo spazio contiguo è massimo
+            _head = _tail = 0;
+        else if(header(_head) == padding_marker){ // il riempimento esce con il record che lo precede
+            _used -= _size - _head;
+            _head = 0;
+        }
+    }
+
+    public:
+        typedef std::pair<const unsigned char*, unsigned int> const_record; ///< record in sola lettura (puntatore, lunghezza)
+
+        /**
+         * @brief Costruttore di default
+         *
+         * @post size() == 0
+         */
+        record_cbuffer(): _arena(nullptr), _size(0), _head(0), _tail(0), _used(0), _records(0), _reserved(0), _reserved_at(0){}
+
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param size dimensione dell'area in byte (arrotondata a un multiplo di 4)
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita
+         */
+        explicit record_cbuffer(int size)
+            : _arena(nullptr), _size(0), _head(0), _tail(0), _used(0), _records(0), _reserved(0), _reserved_at(0){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a record_cbuffer with a negative size");
+            _size = align(size);
+            if(_size > 0)
+                _arena = static_cast<unsigned char*>(::operator new(_size, std::align_val_t(header_size)));
+        }
+
+        /**
+         * @brief Copy constructor: copia l'area così com'è
+         *
+         * @param other coda da copiare
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita
+         */
+        record_cbuffer(const record_cbuffer &other)
+            : _arena(nullptr), _size(other._size), _head(other._head), _tail(other._tail), _used(other._used),
+            _records(other._records), _reserved(0), _reserved_at(0){
+            if(_size > 0){
+                _arena = static_cast<unsigned char*>(::operator new(_size, std::align_val_t(header_size)));
+                std::memcpy(_arena, other._arena, _size);
+            }
+        }
+
+        /**
+         * @brief Move constructor: other rimane senza area con dimensione 0
+         *
+         * @param other coda da spostare
+         */
+        record_cbuffer(record_cbuffer &&other) noexcept: record_cbuffer(){
+            swap(other);
+        }
+
+        /**
+         * @brief Operatore di assegnamento (copy and swap)
+         *
+         * @param other coda da copiare
+         * @return record_cbuffer& reference a this
+         */
+        record_cbuffer& operator=(const record_cbuffer &other){
+            if(this != &other){
+                record_cbuffer tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment
+         *
+         * @param other coda da spostare
+         * @return record_cbuffer& reference a this
+         */
+        record_cbuffer& operator=(record_cbuffer &&other) noexcept{
+            if(this != &other){
+                record_cbuffer tmp(std::move(other));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Distruttore
+         *
+         */
+        ~record_cbuffer(){
+            if(_arena != nullptr)
+                ::operator delete(_arena, std::align_val_t(header_size));
+        }
+
+        /**
+         * @brief Funzione che scambia il contenuto di this con other
+         *
+         * @param other coda da scambiare
+         */
+        void swap(record_cbuffer &other) noexcept{
+            std::swap(_arena, other._arena);
+            std::swap(_size, other._size);
+            std::swap(_head, other._head);
+            std::swap(_tail, other._tail);
+            std::swap(_used, other._used);
+            std::swap(_records, other._records);
+            std::swap(_reserved, other._reserved);
+            std::swap(_reserved_at, other._reserved_at);
+        }
+
+        /**
+         * @brief Funzione che riserva n byte contigui per il prossimo record.
+         * Il record diventa visibile ai lettori solo con commit(); una nuova
+         * reserve annulla quella precedente. Con overwrite_on_full può
+         * scartare i record più vecchi (invalidando i puntatori di peek()).
+         *
+         * @param n lunghezza massima del record
+         * @return unsigned char* puntatore (allineato a 4) a n byte scrivibili, nullptr se il record non entra
+         */
+        unsigned char* reserve(unsigned int n){
+            _reserved = 0;
+            if(n > max_record_size())
+                return nullptr;
+            unsigned int need = align(header_size + n);
+            unsigned int at = 0;
+            while(!fits(need, at)){
+                if(rejects)
+                    return nullptr;
+                drop(); // c'è sempre un record da scartare: a coda vuota il record entra
+            }
+            _reserved = need;
+            _reserved_at = at;
+            return _arena + at + header_size;
+        }
+
+        /**
+         * @brief Funzione che pubblica il record riservato con i primi n byte
+         *
+         * @param n lunghezza effettiva del record (<= quella passata a reserve)
+         * @throw std::logic_error eccezione lanciata se non c'è una reserve attiva
+         * @throw std::out_of_range eccezione lanciata se n supera lo spazio riservato
+         */
+        void commit(unsigned int n){
+            if(_reserved == 0)
+                throw std::logic_error("Cannot commit a record without a reservation");
+            unsigned int bytes = align(header_size + n);
+            if(bytes > _reserved)
+                throw std::out_of_range("Cannot commit more bytes than reserved");
+            if(_reserved_at != _tail){ // il record va all'inizio: il resto dell'area è riempimento
+                set_header(_tail, padding_marker);
+                _used += _size - _tail;
+            }
+            set_header(_reserved_at, n);
+            _tail = _reserved_at + bytes;
+            if(_tail == _size)
+                _tail = 0;
+            _used += bytes;
+            ++_records;
+            _reserved = 0;
+        }
+
+        /**
+         * @brief Funzione che accoda una copia di n byte a partire da data
+         *
+         * @param data byte del record
+         * @param n lunghezza del record
+         * @return true se il record è stato inserito
+         * @return false se il record non entra (vedi reserve)
+         */
+        bool enqueue(const void *data, unsigned int n){
+            unsigned char *p = reserve(n);
+            if(p == nullptr)
+                return false;
+            if(n > 0)
+                std::memcpy(p, data, n);
+            commit(n);
+            return true;
+        }
+
+        /**
+         * @brief Funzione che ritorna il record in testa senza copiarlo.
+         * Il puntatore resta valido fino alla release() del record o a
+         * una reserve() che lo sovrascrive.
+         *
+         * @return const_record puntatore ai byte del record e loro numero
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        const_record peek() const{
+            if(is_empty())
+                throw empty_queue_exception("Cannot get the head from an empty queue");
+            return const_record(_arena + _head + header_size, header(_head));
+        }
+
+        /**
+         * @brief Funzione che rimuove il record in testa
+         *
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione da una coda vuota
+         */
+        void release(){
+            if(is_empty())
+                throw empty_queue_exception("Cannot remove an element from an empty queue");
+            drop();
+        }
+
+        /**
+         * @brief Funzione che svuota la coda (e annulla la reserve attiva)
+         *
+         */
+        void clear(){
+            _head = _tail = _used = _records = _reserved = 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna la lunghezza massima di un record
+         *
+         * @return unsigned int dimensione dell'area meno l'intestazione (0 se size pari a 0)
+         */
+        unsigned int max_record_size() const{
+            return _size < header_size ? 0 : _size - header_size;
+        }
+
+        /**
+         * @brief Funzione che ritorna la dimensione dell'area in byte
+         *
+         * @return unsigned int dimensione dell'area
+         */
+        unsigned int size() const{
+            return _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna i byte occupati (intestazioni,
+         * allineamento e riempimento compresi)
+         *
+         * @return unsigned int byte occupati
+         */
+        unsigned int used_bytes() const{
+            return _used;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di record nella coda
+         *
+         * @return unsigned int numero di record
+         */
+        unsigned int stored_elements() const{
+            return _records;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è vuota
+         *
+         * @return true se la coda è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return _records == 0;
+        }
+};
+
+#endif
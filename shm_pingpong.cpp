@@ -0,0 +1,176 @@
+#include "shm_spsc_cbuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+/**
+ * @file shm_pingpong.cpp
+ * @brief Esempio produttore/consumatore tra due processi con
+ * shm_spsc_cbuffer e misura della latenza di andata e ritorno
+ *
+ * Il produttore crea due code in memoria condivisa: sulla prima invia
+ * messaggi al consumatore, che li rimanda indietro sulla seconda. Per
+ * ogni messaggio il produttore misura il tempo tra l'invio e la
+ * ricezione della risposta e alla fine stampa la distribuzione in
+ * nanosecondi.
+ *
+ * Uso:
+ *   shm_pingpong.exe [-n N]           produttore e consumatore (fork)
+ *   shm_pingpong.exe producer [-n N]  solo il produttore
+ *   shm_pingpong.exe consumer         solo il consumatore
+ *
+ * Con un solo core i due processi si alternano sulla CPU e la latenza
+ * misurata comprende i cambi di contesto.
+ */
+
+/**
+ * @brief Messaggio di 64 byte scambiato tra i processi
+ */
+struct ping_message{
+    std::uint64_t sequence; ///< numero del messaggio (stop_sequence per terminare)
+    std::int64_t sent_ns; ///< istante di invio in nanosecondi
+    char payload[48]; ///< dati
+};
+
+static const std::uint64_t stop_sequence = ~0ull; ///< numero del messaggio che termina il consumatore
+static const char *ping_name = "/cbuffer_ping"; ///< coda produttore -> consumatore
+static const char *pong_name = "/cbuffer_pong"; ///< coda consumatore -> produttore
+
+typedef shm_spsc_cbuffer<ping_message, block_on_full> ping_queue;
+
+/**
+ * @brief Funzione che ritorna l'istante attuale in nanosecondi
+ *
+ * @return std::int64_t nanosecondi dal riferimento di steady_clock
+ */
+std::int64_t now_ns(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Funzione che apre il segmento name, attendendo che il
+ * produttore lo crei
+ *
+ * @param name nome del segmento
+ * @return ping_queue* coda aperta (da distruggere con delete)
+ */
+ping_queue* open_when_ready(const char *name){
+    for(;;){
+        try{
+            return new ping_queue(name);
+        }catch(const std::exception &){
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+/**
+ * @brief Consumatore: rimanda indietro ogni messaggio finché non
+ * riceve quello di terminazione
+ *
+ * @return int codice di uscita
+ */
+int run_consumer(){
+    ping_queue *ping = open_when_ready(ping_name);
+    ping_queue *pong = open_when_ready(pong_name);
+    ping_message message;
+    do{
+        ping->dequeue(message);
+        pong->enqueue(message);
+    }while(message.sequence != stop_sequence);
+    delete ping;
+    delete pong;
+    return 0;
+}
+
+/**
+ * @brief Produttore: crea le code, invia rounds messaggi (più un
+ * riscaldamento non misurato) e stampa la distribuzione delle latenze
+ *
+ * @param rounds numero di messaggi misurati
+ * @return int codice di uscita
+ */
+int run_producer(long long rounds){
+    ping_queue ping(ping_name, 64);
+    ping_queue pong(pong_name, 64);
+
+    const long long warmup = std::min(rounds, 10000LL);
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(rounds);
+    ping_message message;
+    std::memset(&message, 0, sizeof(message));
+    for(long long i = 0; i < warmup + rounds; ++i){
+        message.sequence = i;
+        message.sent_ns = now_ns();
+        ping.enqueue(message);
+        pong.dequeue(message);
+        if(message.sequence != static_cast<std::uint64_t>(i)){
+            std::fprintf(stderr, "unexpected message %llu\n", static_cast<unsigned long long>(message.sequence));
+            return 1;
+        }
+        if(i >= warmup)
+            latencies.push_back(now_ns() - message.sent_ns);
+    }
+    message.sequence = stop_sequence;
+    ping.enqueue(message);
+    pong.dequeue(message);
+
+    if(latencies.empty())
+        return 0;
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for(std::int64_t l : latencies)
+        sum += l;
+    std::size_t n = latencies.size();
+    std::printf("round trips: %zu, message: %zu bytes\n", n, sizeof(ping_message));
+    std::printf("min %lld ns, p50 %lld ns, p99 %lld ns, p99.9 %lld ns, max %lld ns, mean %.0f ns\n",
+        static_cast<long long>(latencies[0]), static_cast<long long>(latencies[n / 2]),
+        static_cast<long long>(latencies[n * 99 / 100]), static_cast<long long>(latencies[n * 999 / 1000]),
+        static_cast<long long>(latencies[n - 1]), sum / n);
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    const char *mode = "both";
+    long long rounds = 100000;
+    for(int i = 1; i < argc; ++i){
+        if(std::strcmp(argv[i], "producer") == 0 || std::strcmp(argv[i], "consumer") == 0)
+            mode = argv[i];
+        else if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            rounds = std::strtoll(argv[++i], nullptr, 10);
+        else{
+            std::fprintf(stderr, "usage: %s [producer|consumer] [-n rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(rounds < 0)
+        rounds = 0;
+
+    if(std::strcmp(mode, "consumer") == 0)
+        return run_consumer();
+    // segmenti rimasti da un'esecuzione interrotta, rimossi prima che il consumatore li apra
+    ping_queue::unlink(ping_name);
+    ping_queue::unlink(pong_name);
+    if(std::strcmp(mode, "producer") == 0)
+        return run_producer(rounds);
+
+    pid_t child = fork();
+    if(child < 0){
+        std::perror("fork");
+        return 1;
+    }
+    if(child == 0)
+        _exit(run_consumer());
+    int result = run_producer(rounds);
+    int status = 0;
+    waitpid(child, &status, 0);
+    return result != 0 ? result : (WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+}
@@ -0,0 +1,384 @@
+#ifndef SHM_SPSC_CBUFFER_H
+#define SHM_SPSC_CBUFFER_H
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <new> // placement new
+#include <string>
+#include <system_error>
+#include <thread> // std::this_thread::yield
+#include <type_traits> // std::is_same, std::is_trivially_copyable
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "negative_queue_size_exception.h"
+#include "invalid_file_exception.h"
+#include "cbuffer_index.h"
+#include "cbuffer_overflow.h"
+#include "cache_line.h"
+
+/**
+ * @brief Struttura all'inizio del segmento di memoria condivisa di uno
+ * shm_spsc_cbuffer
+ *
+ * Il segmento non contiene puntatori: ogni processo lo mappa a un
+ * indirizzo diverso e trova i dati a data_offset byte dall'inizio.
+ * Testa e coda stanno su linee di cache diverse, come in spsc_cbuffer.
+ * Il campo ready viene scritto per ultimo dal creatore: chi apre il
+ * segmento prima che sia inizializzato riceve un errore.
+ */
+struct shm_spsc_header{
+    std::uint32_t version; ///< versione del formato
+    std::uint32_t element_size; ///< sizeof degli elementi
+    std::uint32_t capacity; ///< capacità della coda (potenza di due)
+    std::uint32_t data_offset; ///< distanza in byte dei dati dall'inizio del segmento
+    std::atomic<std::uint32_t> ready; ///< firma scritta dopo l'inizializzazione
+
+    alignas(CBUFFER_CACHE_LINE) std::atomic<std::uint32_t> head; ///< contatore della testa (scritto dal consumatore)
+    alignas(CBUFFER_CACHE_LINE) std::atomic<std::uint32_t> tail; ///< contatore della coda (scritto dal produttore)
+};
+
+/**
+ * @brief Classe shm_spsc_cbuffer
+ *
+ * La classe implementa una coda circolare lock-free tra un processo
+ * produttore e un processo consumatore sullo stesso host, in un segmento
+ * di memoria condivisa POSIX (shm_open + mmap). L'algoritmo è quello di
+ * spsc_cbuffer: contatori monotoni, posizione nell'array data da
+ * pow2_index, copia locale dell'indice dell'altro lato ricaricata solo
+ * quando la coda sembra piena/vuota. Le copie locali vivono
+ * nell'oggetto di ogni processo, non nel segmento, e partono dai
+ * contatori presenti nel segmento al momento dell'apertura.
+ *
+ * Il processo che crea il segmento (costruttore con la dimensione) ne è
+ * il proprietario e lo rimuove con shm_unlink alla distruzione; l'altro
+ * processo lo apre per nome. Ogni oggetto va usato da un solo lato.
+ * Gli elementi sono copiati byte per byte, quindi T deve essere
+ * banalmente copiabile e non contenere puntatori.
+ *
+ * @tparam T Tipo banalmente copiabile degli elementi
+ * @tparam Overflow Politica di inserimento su coda piena (reject_on_full o block_on_full)
+ */
+template<typename T, typename Overflow = reject_on_full> class shm_spsc_cbuffer{
+
+    static_assert(std::is_trivially_copyable<T>::value, "shm_spsc_cbuffer requires a trivially copyable type");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "shm_spsc_cbuffer requires lock-free 32-bit atomics");
+    static_assert(!std::is_same<Overflow, overwrite_on_full>::value,
+        "overwrite_on_full is not supported: the producer cannot overwrite an element the consumer may be reading");
+    static_assert(!std::is_same<Overflow, grow_on_full>::value,
+        "grow_on_full is only supported by cbuffer");
+
+    static const std::uint32_t format_version = 1; ///< versione del formato
+    static const std::uint32_t ready_magic = 0x43425348; ///< firma di segmento inizializzato ("CBSH")
+
+    std::string _name; ///< nome del segmento
+    bool _owner; ///< true se il segmento va rimosso alla distruzione
+    void *_map; ///< inizio del segmento mappato
+    std::size_t _bytes; ///< dimensione del segmento
+    shm_spsc_header *_header; ///< intestazione nel segmento
+    T *_queue; ///< dati nel segmento (indirizzo locale al processo)
+    unsigned int _size; ///< dimensione massima della coda
+    std::uint32_t _head_cache; ///< copia di head letta dal produttore
+    std::uint32_t _tail_cache; ///< copia di tail letta dal consumatore
+
+    /**
+     * @brief Funzione di supporto che ritorna la distanza dei dati
+     * dall'inizio del segmento
+     *
+     * @return std::size_t sizeof dell'intestazione arrotondato all'allineamento di T
+     */
+    static std::size_t data_offset(){
+        return (sizeof(shm_spsc_header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::system_error con errno
+     *
+     * @param what operazione fallita
+     * @throw std::system_error sempre
+     */
+    [[noreturn]] static void throw_system(const std::string &what){
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    /**
+     * @brief Funzione di supporto che crea o apre e mappa il segmento
+     *
+     * @param size dimensione della coda (negativa per aprire un segmento esistente)
+     * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo
+     * @throw invalid_file_exception eccezione lanciata in caso di segmento non valido
+     */
+    void map_segment(int size){
+        bool create = size >= 0;
+        int fd = shm_open(_name.c_str(), create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600);
+        if(fd < 0)
+            throw_system("Cannot open the shared memory " + _name);
+        _owner = create;
+        if(create){
+            _size = pow2_index::capacity(size);
+            _bytes = data_offset() + sizeof(T) * static_cast<std::size_t>(_size);
+            if(ftruncate(fd, _bytes) != 0){
+                int error = errno;
+                close(fd);
+                errno = error;
+                throw_system("Cannot resize the shared memory " + _name);
+            }
+        }else{
+            struct stat st;
+            if(fstat(fd, &st) != 0){
+                int error = errno;
+                close(fd);
+                errno = error;
+                throw_system("Cannot stat the shared memory " + _name);
+            }
+            _bytes = st.st_size;
+        }
+        if(_bytes < sizeof(shm_spsc_header)){
+            close(fd);
+            throw invalid_file_exception("The shared memory " + _name + " is not initialized");
+        }
+        _map = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int error = errno;
+        close(fd); // la mappatura resta valida
+        if(_map == MAP_FAILED){
+            _map = nullptr;
+            errno = error;
+            throw_system("Cannot map the shared memory " + _name);
+        }
+        _header = static_cast<shm_spsc_header*>(_map);
+
+        if(create){
+            // il segmento nuovo è azzerato: gli atomici vengono costruiti al loro posto
+            new (&_header->head) std::atomic<std::uint32_t>(0);
+            new (&_header->tail) std::atomic<std::uint32_t>(0);
+            new (&_header->ready) std::atomic<std::uint32_t>(0);
+            _header->version = format_version;
+            _header->element_size = sizeof(T);
+            _header->capacity = _size;
+            _header->data_offset = data_offset();
+            _header->ready.store(ready_magic, std::memory_order_release);
+        }else{
+            if(_header->ready.load(std::memory_order_acquire) != ready_magic)
+                throw invalid_file_exception("The shared memory " + _name + " is not initialized");
+            if(_header->version != format_version || _header->element_size != sizeof(T))
+                throw invalid_file_exception("The shared memory " + _name + " stores elements of a different type");
+            _size = _header->capacity;
+            if(_size == 0 || (_size & (_size - 1)) != 0) // gli slot si ottengono con & (_size - 1)
+                throw invalid_file_exception("The shared memory " + _name + " stores a capacity that is not a power of two");
+            if(_header->data_offset != data_offset() || _bytes < data_offset() + sizeof(T) * static_cast<std::size_t>(_size))
+                throw invalid_file_exception("The shared memory " + _name + " has an inconsistent size");
+        }
+        _queue = reinterpret_cast<T*>(static_cast<char*>(_map) + _header->data_offset);
+        // il segmento può essere già stato usato: le copie partono dai contatori attuali
+        _head_cache = _header->head.load(std::memory_order_acquire);
+        _tail_cache = _header->tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Funzione di supporto che rilascia la mappatura e, se this
+     * è il proprietario, rimuove il segmento
+     *
+     */
+    void release(){
+        if(_map != nullptr)
+            munmap(_map, _bytes);
+        if(_owner)
+            shm_unlink(_name.c_str());
+        _map = nullptr;
+        _owner = false;
+    }
+
+    /**
+     * @brief Funzione di supporto che mappa il segmento in modo sicuro
+     * rispetto alle eccezioni
+     *
+     * @param size dimensione della coda (negativa per aprire un segmento esistente)
+     */
+    void open_segment(int size){
+        try{
+            map_segment(size);
+        }catch(...){
+            release();
+            throw;
+        }
+    }
+
+    public:
+        /**
+         * @brief Costruttore secondario che crea il segmento name (che non
+         * deve esistere) con una coda vuota. this ne diventa proprietario.
+         *
+         * @param name nome del segmento, nella forma "/nome"
+         * @param size dimensione massima della coda (arrotondata a una potenza di due)
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo (anche segmento già esistente)
+         */
+        shm_spsc_cbuffer(const std::string &name, int size)
+            : _name(name), _owner(false), _map(nullptr), _bytes(0), _header(nullptr), _queue(nullptr), _size(0), _head_cache(0), _tail_cache(0){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a shm_spsc_cbuffer with a negative size");
+            open_segment(size);
+        }
+
+        /**
+         * @brief Costruttore secondario che apre il segmento name creato
+         * da un altro shm_spsc_cbuffer
+         *
+         * @param name nome del segmento, nella forma "/nome"
+         * @throw invalid_file_exception eccezione lanciata in caso di segmento non inizializzato, di un altro tipo
+         * o con una capacità che non è una potenza di due non nulla
+         * @throw std::system_error eccezione lanciata in caso di errore del sistema operativo (anche segmento inesistente)
+         */
+        explicit shm_spsc_cbuffer(const std::string &name)
+            : _name(name), _owner(false), _map(nullptr), _bytes(0), _header(nullptr), _queue(nullptr), _size(0), _head_cache(0), _tail_cache(0){
+            open_segment(-1);
+        }
+
+        shm_spsc_cbuffer(const shm_spsc_cbuffer &other) = delete;
+        shm_spsc_cbuffer& operator=(const shm_spsc_cbuffer &other) = delete;
+
+        /**
+         * @brief Distruttore: rilascia la mappatura e rimuove il segmento
+         * se this lo ha creato (chi lo ha già aperto può continuare a usarlo)
+         *
+         */
+        ~shm_spsc_cbuffer(){
+            release();
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che accoda una copia di value
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena
+         */
+        bool try_enqueue(const T &value){
+            std::uint32_t tail = _header->tail.load(std::memory_order_relaxed);
+            if(tail - _head_cache == _size){
+                _head_cache = _header->head.load(std::memory_order_acquire);
+                if(tail - _head_cache == _size)
+                    return false;
+            }
+            _queue[pow2_index::slot(tail, _size)] = value;
+            _header->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che accoda una copia di value.
+         * Se la coda è piena ritorna false (reject_on_full) oppure attende
+         * che il consumatore liberi uno slot (block_on_full).
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        bool enqueue(const T &value){
+            if constexpr (std::is_same<Overflow, block_on_full>::value){
+                if(_size == 0)
+                    return false;
+                while(!try_enqueue(value))
+                    std::this_thread::yield();
+                return true;
+            }else
+                return try_enqueue(value);
+        }
+
+        /**
+         * @brief Funzione (solo consumatore) che rimuove l'elemento in testa
+         * copiandolo in value
+         *
+         * @param value riferimento in cui copiare l'elemento rimosso
+         * @return true se un elemento è stato rimosso
+         * @return false se la coda è vuota
+         */
+        bool try_dequeue(T &value){
+            std::uint32_t head = _header->head.load(std::memory_order_relaxed);
+            if(head == _tail_cache){
+                _tail_cache = _header->tail.load(std::memory_order_acquire);
+                if(head == _tail_cache)
+                    return false;
+            }
+            value = _queue[pow2_index::slot(head, _size)];
+            _header->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Funzione (solo consumatore) che rimuove l'elemento in testa,
+         * attendendo che il produttore ne inserisca uno se la coda è vuota
+         *
+         * @param value riferimento in cui copiare l'elemento rimosso
+         */
+        void dequeue(T &value){
+            while(!try_dequeue(value))
+                std::this_thread::yield();
+        }
+
+        /**
+         * @brief Funzione che rimuove il segmento name, ad esempio rimasto
+         * da un proprietario terminato senza distruttore
+         *
+         * @param name nome del segmento, nella forma "/nome"
+         * @return true se il segmento esisteva ed è stato rimosso
+         * @return false altrimenti
+         */
+        static bool unlink(const std::string &name){
+            return shm_unlink(name.c_str()) == 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna il nome del segmento
+         *
+         * @return const std::string& nome del segmento
+         */
+        const std::string& name() const{
+            return _name;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è vuota. Il valore
+         * è esatto solo se letto dal produttore o dal consumatore
+         *
+         * @return true se la coda è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return stored_elements() == 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è piena. Il valore
+         * è esatto solo se letto dal produttore o dal consumatore
+         *
+         * @return true se la coda è piena
+         * @return false altrimenti
+         */
+        bool is_full() const{
+            return stored_elements() == _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna la dimensione massima della coda
+         *
+         * @return unsigned int dimensione della coda
+         */
+        unsigned int size() const{
+            return _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di elementi salvati
+         * nella coda (istantanea, può cambiare subito dopo)
+         *
+         * @return unsigned int
+         */
+        unsigned int stored_elements() const{
+            std::uint32_t head = _header->head.load(std::memory_order_acquire);
+            return _header->tail.load(std::memory_order_acquire) - head;
+        }
+};
+
+#endif
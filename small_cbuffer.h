@@ -0,0 +1,105 @@
+#ifndef SMALL_CBUFFER_H
+#define SMALL_CBUFFER_H
+#include <memory> // std::allocator, std::allocator_traits
+#include <type_traits> // std::true_type
+#include "cbuffer.h"
+/**
+ * @brief Classe small_buffer_allocator
+ *
+ * Allocatore per cbuffer con ottimizzazione per code piccole: un cbuffer
+ * con questo allocatore contiene K slot nell'oggetto (inline_capacity) e
+ * li usa quando la capacità non supera K. Per capacità maggiori l'array
+ * viene allocato con Allocator, a cui sono inoltrate tutte le operazioni.
+ *
+ * Con i dati nell'oggetto la coda non chiama l'allocatore né alla
+ * creazione né alla distruzione e gli accessi non passano dal puntatore
+ * _queue: l'indirizzo degli slot viene calcolato da this (vedi
+ * cbuffer::data()), quindi leggere un elemento non richiede di caricare
+ * prima il puntatore all'array.
+ *
+ * Con i dati nell'oggetto lo spostamento della coda sposta gli elementi
+ * uno a uno (al più K), invece di prendere l'array.
+ *
+ * @tparam T tipo degli elementi allocati
+ * @tparam K numero di elementi salvati nell'oggetto
+ * @tparam Allocator allocatore usato oltre K elementi
+ */
+template<typename T, unsigned int K, typename Allocator = std::allocator<T>>
+class small_buffer_allocator : public std::allocator_traits<Allocator>::template rebind_alloc<T>{
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T> base; ///< allocatore oltre K elementi
+    typedef std::allocator_traits<base> base_traits;
+
+    public:
+        typedef T value_type;
+        typedef typename base_traits::propagate_on_container_copy_assignment propagate_on_container_copy_assignment;
+        typedef typename base_traits::propagate_on_container_move_assignment propagate_on_container_move_assignment;
+        typedef typename base_traits::propagate_on_container_swap propagate_on_container_swap;
+        typedef typename base_traits::is_always_equal is_always_equal;
+
+        static constexpr unsigned int inline_capacity = K; ///< elementi salvati nell'oggetto dal cbuffer
+
+        /**
+         * @brief Rebind su U (lo stesso numero K di elementi)
+         */
+        template<typename U> struct rebind{
+            typedef small_buffer_allocator<U, K, typename std::allocator_traits<Allocator>::template rebind_alloc<U>> other;
+        };
+
+        small_buffer_allocator() = default;
+
+        /**
+         * @brief Costruttore a partire dall'allocatore usato oltre K elementi
+         *
+         * @param alloc allocatore da copiare
+         */
+        small_buffer_allocator(const base &alloc): base(alloc){}
+
+        /**
+         * @brief Costruttore di conversione da un small_buffer_allocator di altro tipo
+         *
+         * @param other allocatore da convertire
+         */
+        template<typename U, typename A> small_buffer_allocator(const small_buffer_allocator<U, K, A> &other)
+            : base(static_cast<const A&>(other)){}
+
+        /**
+         * @brief Funzione che ritorna l'allocatore usato oltre K elementi
+         *
+         * @return const base& allocatore sottostante
+         */
+        const base& upstream() const noexcept{
+            return *this;
+        }
+
+        /**
+         * @brief Copia per il copy constructor del contenitore
+         *
+         * @return small_buffer_allocator allocatore della copia
+         */
+        small_buffer_allocator select_on_container_copy_construction() const{
+            return small_buffer_allocator(base_traits::select_on_container_copy_construction(*this));
+        }
+
+        template<typename U, typename A> bool operator==(const small_buffer_allocator<U, K, A> &other) const noexcept{
+            return upstream() == other.upstream();
+        }
+
+        template<typename U, typename A> bool operator!=(const small_buffer_allocator<U, K, A> &other) const noexcept{
+            return !(*this == other);
+        }
+};
+
+/**
+ * @brief cbuffer che salva fino a K elementi nell'oggetto e alloca
+ * l'array sullo heap solo per capacità maggiori
+ *
+ * @tparam T Tipo degli elementi contenuti nella coda
+ * @tparam K Capacità massima con i dati nell'oggetto
+ * @tparam Index Politica di indicizzazione (modulo_index o pow2_index)
+ * @tparam Overflow Politica di inserimento su coda piena (overwrite_on_full o reject_on_full)
+ */
+template<typename T, unsigned int K, typename Index = modulo_index, typename Overflow = overwrite_on_full>
+using small_cbuffer = cbuffer<T, Index, Overflow, small_buffer_allocator<T, K>>;
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef SPSC_CBUFFER_H
+#define SPSC_CBUFFER_H
+#include <atomic>
+#include <thread> // std::this_thread::yield
+#include <type_traits> // std::is_same
+#include <new> // placement new, std::align_val_t
+#include <utility> // std::move, std::forward
+#include "negative_queue_size_exception.h"
+#include "cbuffer_index.h"
+#include "cbuffer_overflow.h"
+#include "cache_line.h"
+/**
+ * @brief Classe spsc_cbuffer
+ *
+ * La classe implementa una coda circolare lock-free per un solo thread
+ * produttore e un solo thread consumatore. Come cbuffer gli elementi sono
+ * salvati in memoria non inizializzata e costruiti solo all'inserimento;
+ * gli indici sono contatori monotoni atomici e la posizione nell'array
+ * si ottiene con pow2_index (la capacità è arrotondata a una potenza di due).
+ *
+ * Testa e coda stanno su linee di cache diverse: il produttore scrive solo
+ * _tail e il consumatore solo _head. Ognuno tiene una copia locale
+ * dell'indice dell'altro, ricaricata solo quando la coda sembra piena/vuota.
+ * A differenza di cbuffer, quando la coda è piena try_enqueue fallisce
+ * mentre enqueue si comporta secondo la politica Overflow.
+ *
+ * @tparam T Tipo degli elementi contenuti nella coda
+ * @tparam Overflow Politica di inserimento su coda piena (reject_on_full o block_on_full)
+ */
+template<typename T, typename Overflow = reject_on_full> class spsc_cbuffer{
+
+    static_assert(!std::is_same<Overflow, overwrite_on_full>::value,
+        "overwrite_on_full is not supported: the producer cannot destroy an element the consumer may be reading");
+    static_assert(!std::is_same<Overflow, grow_on_full>::value,
+        "grow_on_full is only supported by cbuffer");
+
+    alignas(CBUFFER_CACHE_LINE) std::atomic<unsigned int> _head; ///< contatore della testa (scritto dal consumatore)
+    unsigned int _tail_cache; ///< copia di _tail letta dal consumatore
+
+    alignas(CBUFFER_CACHE_LINE) std::atomic<unsigned int> _tail; ///< contatore della coda (scritto dal produttore)
+    unsigned int _head_cache; ///< copia di _head letta dal produttore
+
+    alignas(CBUFFER_CACHE_LINE) unsigned int _size; ///< dimensione massima della coda
+    T *_queue; ///< puntatore all'area di memoria (non inizializzata) in cui sono salvati i dati
+
+    public:
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param size dimensione massima della coda (arrotondata a una potenza di due)
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione dell'array non riuscita
+         */
+        explicit spsc_cbuffer(int size): _head(0), _tail_cache(0), _tail(0), _head_cache(0), _size(0), _queue(nullptr){
+            if(size < 0)
+                throw negative_queue_size_exception("Cannot create a spsc_cbuffer with a negative size");
+            _size = pow2_index::capacity(size);
+            _queue = static_cast<T*>(::operator new(sizeof(T) * _size, std::align_val_t(alignof(T))));
+        }
+
+        spsc_cbuffer(const spsc_cbuffer &other) = delete;
+        spsc_cbuffer& operator=(const spsc_cbuffer &other) = delete;
+
+        /**
+         * @brief Distruttore: distrugge gli elementi non ancora letti
+         *
+         */
+        ~spsc_cbuffer(){
+            unsigned int tail = _tail.load(std::memory_order_relaxed);
+            for(unsigned int i = _head.load(std::memory_order_relaxed); i != tail; ++i)
+                _queue[pow2_index::slot(i, _size)].~T();
+            ::operator delete(_queue, std::align_val_t(alignof(T)));
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che costruisce in coda un nuovo
+         * elemento a partire dagli argomenti passati in input
+         *
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena
+         */
+        template<typename... Args> bool try_emplace(Args&&... args){
+            unsigned int tail = _tail.load(std::memory_order_relaxed);
+            if(tail - _head_cache == _size){
+                _head_cache = _head.load(std::memory_order_acquire);
+                if(tail - _head_cache == _size)
+                    return false;
+            }
+            new (_queue + pow2_index::slot(tail, _size)) T(std::forward<Args>(args)...);
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che costruisce in coda un nuovo elemento.
+         * Se la coda è piena ritorna false (reject_on_full) oppure attende
+         * che si liberi uno slot (block_on_full).
+         *
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        template<typename... Args> bool emplace(Args&&... args){
+            if constexpr (std::is_same<Overflow, block_on_full>::value){
+                if(_size == 0)
+                    return false;
+                // gli argomenti vengono usati solo dal tentativo che riesce
+                while(!try_emplace(std::forward<Args>(args)...))
+                    std::this_thread::yield();
+                return true;
+            }else
+                return try_emplace(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che accoda una copia di value secondo la politica Overflow
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        bool enqueue(const T &value){
+            return emplace(value);
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che accoda value spostandolo secondo la politica Overflow
+         *
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda ha size pari a 0 oppure è piena e Overflow è reject_on_full
+         */
+        bool enqueue(T &&value){
+            return emplace(std::move(value));
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che accoda una copia di value
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena
+         */
+        bool try_enqueue(const T &value){
+            return try_emplace(value);
+        }
+
+        /**
+         * @brief Funzione (solo produttore) che accoda value spostandolo
+         *
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena (value non viene spostato)
+         */
+        bool try_enqueue(T &&value){
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * @brief Funzione (solo consumatore) che rimuove l'elemento in testa
+         * spostandolo in value
+         *
+         * @param value riferimento in cui spostare l'elemento rimosso
+         * @return true se un elemento è stato rimosso
+         * @return false se la coda è vuota
+         */
+        bool try_dequeue(T &value){
+            unsigned int head = _head.load(std::memory_order_relaxed);
+            if(head == _tail_cache){
+                _tail_cache = _tail.load(std::memory_order_acquire);
+                if(head == _tail_cache)
+                    return false;
+            }
+            T *p = _queue + pow2_index::slot(head, _size);
+            value = std::move(*p);
+            p->~T();
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è vuota. Il valore
+         * è esatto solo se letto dal produttore o dal consumatore
+         *
+         * @return true se la coda è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return stored_elements() == 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è piena. Il valore
+         * è esatto solo se letto dal produttore o dal consumatore
+         *
+         * @return true se la coda è piena
+         * @return false altrimenti
+         */
+        bool is_full() const{
+            return stored_elements() == _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna la dimensione massima della coda
+         *
+         * @return unsigned int dimensione della coda
+         */
+        unsigned int size() const{
+            return _size;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di elementi salvati
+         * nella coda (istantanea, può cambiare subito dopo)
+         *
+         * @return unsigned int
+         */
+        unsigned int stored_elements() const{
+            unsigned int head = _head.load(std::memory_order_acquire);
+            return _tail.load(std::memory_order_acquire) - head;
+        }
+};
+
+#endif
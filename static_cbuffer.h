@@ -0,0 +1,950 @@
+#ifndef STATIC_CBUFFER_H
+#define STATIC_CBUFFER_H
+#include <algorithm> // std::min, std::rotate
+#include <cstddef> // std::ptrdiff_t
+#include <iterator> // std::iterator_traits, std::next, std::make_move_iterator
+#include <memory> // std::uninitialized_copy
+#include <new> // placement new
+#include <optional>
+#include <ostream>
+#include <stdexcept> // std::out_of_range
+#include <type_traits> // std::is_same, std::is_trivial, std::is_trivially_destructible
+#include <utility> // std::move, std::forward
+#include "cbuffer.h"
+
+/**
+ * @brief Slot di static_cbuffer per T banali: un array di T inizializzato
+ * a zero, così la coda è un tipo letterale e tutte le operazioni sono
+ * utilizzabili nelle espressioni costanti (in C++17 ogni oggetto deve
+ * essere inizializzato). Copia e spostamento sono quelli dell'array.
+ *
+ * @tparam T tipo degli elementi (banale)
+ * @tparam N numero di slot
+ * @tparam Trivial true se T è banale (std::is_trivial)
+ */
+template<typename T, unsigned int N, bool Trivial = std::is_trivial<T>::value> class static_cbuffer_storage{
+    T _slots[N]; ///< slot della coda
+
+    protected:
+        unsigned int _head; ///< posizione della testa nell'array, in [0, N)
+        unsigned int _stored_elements; ///< numero di elementi salvati
+
+        constexpr static_cbuffer_storage(): _slots(), _head(0), _stored_elements(0){}
+
+        constexpr T* data() noexcept{
+            return _slots;
+        }
+
+        constexpr const T* data() const noexcept{
+            return _slots;
+        }
+};
+
+/**
+ * @brief Slot di static_cbuffer per T non banali: area non inizializzata
+ * (come gli slot nell'oggetto di cbuffer) in cui vengono costruiti solo
+ * gli elementi salvati, quindi T non deve essere costruibile per default.
+ * Copia, spostamento e distruzione riguardano solo gli elementi salvati.
+ *
+ * @tparam T tipo degli elementi
+ * @tparam N numero di slot
+ */
+template<typename T, unsigned int N> class static_cbuffer_storage<T, N, false>{
+    cbuffer_inline_storage<T, N> _slots; ///< slot non inizializzati
+
+    /**
+     * @brief Funzione di supporto che distrugge gli elementi salvati
+     *
+     * @post _head == 0
+     * @post _stored_elements == 0
+     */
+    void destroy_elements() noexcept{
+        for(unsigned int i = 0; i < _stored_elements; ++i)
+            data()[(_head + i) % N].~T();
+        _head = _stored_elements = 0;
+    }
+
+    /**
+     * @brief Funzione di supporto che costruisce in fondo n elementi a
+     * partire da src. La testa deve essere 0: gli slot sono contigui.
+     *
+     * @tparam It tipo dell'iteratore sorgente
+     * @param src iteratore sorgente
+     * @param n numero di elementi
+     */
+    template<typename It> void append(It src, unsigned int n){
+        for(; n > 0; --n, ++src){
+            new (data() + _stored_elements) T(*src);
+            _stored_elements++; // se la costruzione lancia, la coda contiene gli elementi già costruiti
+        }
+    }
+
+    /**
+     * @brief Funzione di supporto che costruisce gli elementi di other
+     * all'inizio degli slot, un segmento contiguo alla volta: vengono
+     * copiati se Storage è const, altrimenti spostati. This non deve
+     * avere elementi.
+     *
+     * @tparam Storage static_cbuffer_storage, eventualmente const
+     * @param other slot da cui prendere gli elementi
+     */
+    template<typename Storage> void append_from(Storage &other){
+        unsigned int first = std::min(other._stored_elements, N - other._head);
+        if constexpr(std::is_const<Storage>::value){
+            append(other.data() + other._head, first);
+            append(other.data(), other._stored_elements - first);
+        }else{
+            append(std::make_move_iterator(other.data() + other._head), first);
+            append(std::make_move_iterator(other.data()), other._stored_elements - first);
+        }
+    }
+
+    protected:
+        unsigned int _head; ///< posizione della testa nell'array, in [0, N)
+        unsigned int _stored_elements; ///< numero di elementi salvati
+
+        static_cbuffer_storage(): _head(0), _stored_elements(0){}
+
+        static_cbuffer_storage(const static_cbuffer_storage &other): _head(0), _stored_elements(0){
+            try{
+                append_from(other);
+            }catch(...){
+                destroy_elements();
+                throw;
+            }
+        }
+
+        static_cbuffer_storage(static_cbuffer_storage &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : _head(0), _stored_elements(0){
+            try{
+                append_from(other);
+            }catch(...){
+                destroy_elements();
+                throw;
+            }
+        }
+
+        static_cbuffer_storage& operator=(const static_cbuffer_storage &other){
+            if(this != &other){
+                destroy_elements();
+                append_from(other);
+            }
+            return *this;
+        }
+
+        static_cbuffer_storage& operator=(static_cbuffer_storage &&other) noexcept(std::is_nothrow_move_constructible<T>::value){
+            if(this != &other){
+                destroy_elements();
+                append_from(other);
+            }
+            return *this;
+        }
+
+        ~static_cbuffer_storage(){
+            destroy_elements();
+        }
+
+        T* data() noexcept{
+            return _slots.data();
+        }
+
+        const T* data() const noexcept{
+            return _slots.data();
+        }
+};
+
+/**
+ * @brief Classe static_cbuffer
+ *
+ * Coda circolare con capacità N fissata a tempo di compilazione e dati
+ * salvati nell'oggetto (come std::array), quindi senza allocazioni: può
+ * stare sullo stack o dentro un'altra struttura. Poiché la capacità è una
+ * costante, il modulo che calcola lo slot diventa una maschera (N potenza
+ * di due) o una moltiplicazione, senza leggere la dimensione dalla memoria.
+ *
+ * L'interfaccia è quella di cbuffer (senza allocatore e I/O su descrittori),
+ * iteratori compresi. Come in cbuffer gli elementi vengono costruiti in loco
+ * negli slot liberi e distrutti alla rimozione, quindi T non deve essere
+ * costruibile per default. Le operazioni sono constexpr solo per T banali
+ * (std::is_trivial): in quel caso gli slot sono un array di T inizializzato
+ * a zero alla costruzione e la coda è utilizzabile nelle espressioni
+ * costanti; per gli altri T gli slot sono un'area non inizializzata e le
+ * operazioni non possono essere valutate a tempo di compilazione.
+ *
+ * @tparam T Tipo degli elementi contenuti nella coda
+ * @tparam N Capacità della coda (> 0)
+ * @tparam Overflow Politica di inserimento su coda piena (overwrite_on_full o reject_on_full)
+ */
+template<typename T, unsigned int N, typename Overflow = overwrite_on_full>
+class static_cbuffer : private static_cbuffer_storage<T, N>{
+
+    static_assert(N > 0, "static_cbuffer requires a positive capacity");
+    static_assert(!std::is_same<Overflow, block_on_full>::value,
+        "block_on_full is only supported by the concurrent queues (spsc_cbuffer, mpmc_cbuffer)");
+    static_assert(!std::is_same<Overflow, grow_on_full>::value,
+        "grow_on_full is only supported by cbuffer");
+
+    static constexpr bool rejects = std::is_same<Overflow, reject_on_full>::value; ///< true se la coda piena rifiuta gli inserimenti
+    static constexpr bool trivial = std::is_trivial<T>::value; ///< true se gli slot sono un array di T (percorso constexpr)
+
+    typedef static_cbuffer_storage<T, N> storage; ///< slot, testa e numero di elementi
+
+    using storage::_head;
+    using storage::_stored_elements;
+    using storage::data;
+
+    template<typename C, typename V> friend class cbuffer_iterator; ///< gli iteratori leggono gli slot con at_offset
+
+    /**
+     * @brief Funzione di supporto che ritorna la posizione nell'array
+     * dell'elemento a distanza offset dalla testa
+     *
+     * @param offset distanza dalla testa
+     * @return unsigned int posizione nell'array
+     */
+    constexpr unsigned int slot(unsigned int offset) const noexcept{
+        return (_head + offset) % N;
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna l'elemento a distanza
+     * offset dalla testa, senza controlli (usata dagli iteratori)
+     *
+     * @param offset distanza dalla testa
+     * @return T& riferimento dell'elemento
+     */
+    constexpr T& at_offset(unsigned int offset){
+        return data()[slot(offset)];
+    }
+
+    /**
+     * @brief Funzione di supporto che ritorna l'elemento a distanza
+     * offset dalla testa, senza controlli (usata dagli iteratori)
+     *
+     * @param offset distanza dalla testa
+     * @return const T& riferimento dell'elemento
+     */
+    constexpr const T& at_offset(unsigned int offset) const{
+        return data()[slot(offset)];
+    }
+
+    /**
+     * @brief Funzione di supporto che costruisce un elemento nello slot
+     * libero i a partire da args (per T banali lo slot viene assegnato)
+     *
+     * @tparam Args tipi degli argomenti del costruttore di T
+     * @param i posizione nell'array
+     * @param args argomenti del costruttore di T
+     * @return T& riferimento dell'elemento costruito
+     */
+    template<typename... Args> constexpr T& construct(unsigned int i, Args&&... args){
+        if constexpr(trivial){
+            data()[i] = T(std::forward<Args>(args)...);
+            return data()[i];
+        }else{
+            return *new (data() + i) T(std::forward<Args>(args)...);
+        }
+    }
+
+    /**
+     * @brief Funzione di supporto che distrugge n elementi a partire
+     * dalla posizione i. Non fa nulla se T ha il distruttore banale.
+     *
+     * @param i posizione nell'array del primo elemento
+     * @param n numero di elementi contigui
+     */
+    constexpr void destroy(unsigned int i, unsigned int n = 1){
+        if constexpr(!std::is_trivially_destructible<T>::value){
+            for(T *p = data() + i; n > 0; --n, ++p)
+                p->~T();
+        }
+    }
+
+    /**
+     * @brief Funzione di supporto che rimuove l'elemento in testa.
+     * La coda non deve essere vuota.
+     *
+     * @post _stored_elements = _stored_elements - 1
+     */
+    constexpr void pop_head(){
+        destroy(_head);
+        _head = _head + 1 == N ? 0 : _head + 1;
+        _stored_elements--;
+    }
+
+    /**
+     * @brief Funzione di supporto che accoda value copiandolo o
+     * spostandolo a seconda della categoria di U
+     *
+     * @tparam U tipo del valore (const T& oppure T)
+     * @param value valore da inserire
+     * @return true se l'elemento è stato inserito
+     * @return false se la coda è piena e Overflow è reject_on_full
+     */
+    template<typename U> constexpr bool push(U &&value){
+        if(_stored_elements == N){
+            if constexpr(rejects){
+                return false;
+            }else{
+                data()[_head] = std::forward<U>(value); // sovrascrive l'elemento più vecchio
+                _head = _head + 1 == N ? 0 : _head + 1;
+                return true;
+            }
+        }
+        construct(slot(_stored_elements), std::forward<U>(value));
+        _stored_elements++;
+        return true;
+    }
+
+    /**
+     * @brief Funzione di supporto che costruisce n elementi negli slot
+     * liberi a partire da src, in al più due segmenti contigui
+     * (std::uninitialized_copy per T non banali, un ciclo senza modulo
+     * per T banali, che resta constexpr)
+     *
+     * @tparam It tipo dell'iteratore sorgente (forward)
+     * @param src iteratore sorgente, spostato in avanti di n posizioni
+     * @param n numero di elementi da costruire (non più degli slot liberi)
+     * @post _stored_elements = _stored_elements + n
+     */
+    template<typename It> constexpr void construct_segments(It &src, unsigned int n){
+        unsigned int start = slot(_stored_elements);
+        unsigned int first = std::min(n, N - start);
+        for(unsigned int len : {first, n - first}){
+            T *dst = data() + slot(_stored_elements);
+            if constexpr(trivial){
+                for(unsigned int i = 0; i < len; ++i, ++src)
+                    dst[i] = static_cast<T>(*src);
+            }else{
+                It end = std::next(src, len);
+                std::uninitialized_copy(src, end, dst);
+                src = end;
+            }
+            _stored_elements += len;
+        }
+    }
+
+    /**
+     * @brief Funzione di supporto che assegna n elementi agli slot occupati
+     * a partire dalla testa, in al più due segmenti contigui. La coda deve
+     * essere piena.
+     *
+     * @tparam It tipo dell'iteratore sorgente (forward)
+     * @param src iteratore sorgente, spostato in avanti di n posizioni
+     * @param n numero di elementi da assegnare
+     * @post la testa è spostata in avanti di n posizioni
+     */
+    template<typename It> constexpr void assign_segments(It &src, unsigned int n){
+        unsigned int first = std::min(n, N - _head);
+        for(unsigned int i = 0; i < first; ++i, ++src)
+            data()[_head + i] = static_cast<T>(*src);
+        for(unsigned int i = 0; i < n - first; ++i, ++src)
+            data()[i] = static_cast<T>(*src);
+        _head = slot(n);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia empty_queue_exception
+     *
+     * @param message stringa contenente il messaggio
+     * @throw empty_queue_exception sempre
+     */
+    [[noreturn]] CBUFFER_COLD static void throw_empty(const char *message){
+        throw empty_queue_exception(message);
+    }
+
+    /**
+     * @brief Funzione di supporto che lancia std::out_of_range per operator[]
+     *
+     * @throw std::out_of_range sempre
+     */
+    [[noreturn]] CBUFFER_COLD static void throw_out_of_range(){
+        throw std::out_of_range("Cannot call the operator[] due to an index out of bound");
+    }
+
+    public:
+        /**
+         * @brief Costruttore di default: coda vuota con N slot
+         *
+         * @post _head == 0
+         * @post _stored_elements == 0
+         */
+        constexpr static_cbuffer(){}
+
+        /**
+         * @brief Costruttore templato sul tipo Q: accoda gli elementi
+         * della sequenza [b, e) secondo Overflow
+         *
+         * @tparam Q tipo dell'iteratore passato in input
+         * @param b iteratore di inizio
+         * @param e iteratore di fine
+         */
+        template<typename Q> constexpr static_cbuffer(Q b, Q e){
+            enqueue_range(b, e);
+        }
+
+        /**
+         * @brief Funzione che distrugge gli elementi salvati e
+         * azzera la testa e il numero di elementi salvati. In tempo
+         * costante se T ha il distruttore banale.
+         *
+         * @post _head == 0
+         * @post _stored_elements == 0
+         */
+        constexpr void clear(){
+            unsigned int first = std::min(_stored_elements, N - _head);
+            destroy(_head, first);
+            destroy(0, _stored_elements - first);
+            _head = 0;
+            _stored_elements = 0;
+        }
+
+        /**
+         * @brief Funzione che accoda il valore passato in input secondo
+         * la logica FIFO. Se la coda è piena l'elemento più vecchio viene
+         * sovrascritto (overwrite_on_full) oppure l'inserimento viene
+         * rifiutato (reject_on_full).
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full
+         */
+        constexpr bool enqueue(const T &value){
+            return push(value);
+        }
+
+        /**
+         * @brief Funzione che accoda il valore passato in input
+         * spostandolo nella coda
+         *
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full (value non viene spostato)
+         */
+        constexpr bool enqueue(T &&value){
+            return push(std::move(value));
+        }
+
+        /**
+         * @brief Funzione che costruisce in coda un nuovo elemento a partire
+         * dagli argomenti passati in input, senza copie né spostamenti.
+         * Se la coda è piena l'elemento più vecchio viene distrutto
+         * e sostituito, quindi gli argomenti non devono riferirsi
+         * ad elementi della coda.
+         *
+         * Disponibile solo con overwrite_on_full (con reject_on_full usare try_emplace).
+         *
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return T& riferimento all'elemento inserito
+         */
+        template<typename... Args> constexpr T& emplace(Args&&... args){
+            static_assert(!rejects, "emplace cannot report a rejected insertion: use try_emplace");
+            if(is_full()) //libero lo slot dell'elemento più vecchio
+                pop_head();
+            T &p = construct(slot(_stored_elements), std::forward<Args>(args)...);
+            _stored_elements++;
+            return p;
+        }
+
+        /**
+         * @brief Funzione che costruisce in coda un nuovo elemento a partire
+         * dagli argomenti passati in input. Se la coda è piena si comporta secondo Overflow.
+         *
+         * @tparam Args tipi degli argomenti del costruttore di T
+         * @param args argomenti del costruttore di T
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full
+         */
+        template<typename... Args> constexpr bool try_emplace(Args&&... args){
+            if(is_full()){
+                if constexpr(rejects)
+                    return false;
+                else
+                    pop_head();
+            }
+            construct(slot(_stored_elements), std::forward<Args>(args)...);
+            _stored_elements++;
+            return true;
+        }
+
+        /**
+         * @brief Funzione che accoda una copia di value (equivalente a enqueue,
+         * la capacità non è mai nulla)
+         *
+         * @param value valore da inserire
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full
+         */
+        constexpr bool try_enqueue(const T &value){
+            return push(value);
+        }
+
+        /**
+         * @brief Funzione che accoda value spostandolo (equivalente a enqueue)
+         *
+         * @param value valore da spostare in coda
+         * @return true se l'elemento è stato inserito
+         * @return false se la coda è piena e Overflow è reject_on_full (value non viene spostato)
+         */
+        constexpr bool try_enqueue(T &&value){
+            return push(std::move(value));
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa spostandolo
+         * nel valore di ritorno
+         *
+         * @return T elemento rimosso
+         * @post _stored_elements = _stored_elements - 1
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione di un elemento da una coda vuota
+         */
+        constexpr T pop(){
+            if(is_empty())
+                throw_empty("Cannot remove an element from an empty queue");
+            T value(std::move(data()[_head]));
+            pop_head();
+            return value;
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa
+         *
+         * @return T elemento rimosso (equivalente a pop())
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione di un elemento da una coda vuota
+         */
+        constexpr T dequeue(){
+            return pop();
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in coda (l'ultimo inserito)
+         * spostandolo nel valore di ritorno
+         *
+         * @return T elemento rimosso
+         * @post _stored_elements = _stored_elements - 1
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione di un elemento da una coda vuota
+         */
+        constexpr T pop_tail(){
+            if(is_empty())
+                throw_empty("Cannot remove an element from an empty queue");
+            unsigned int tail = slot(_stored_elements - 1);
+            T value(std::move(data()[tail]));
+            destroy(tail);
+            _stored_elements--;
+            return value;
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa spostandolo in value,
+         * senza lanciare eccezioni se la coda è vuota
+         *
+         * @param value riferimento in cui spostare l'elemento rimosso
+         * @return true se un elemento è stato rimosso
+         * @return false se la coda è vuota (value non viene modificato)
+         */
+        constexpr bool try_dequeue(T &value){
+            if(is_empty())
+                return false;
+            value = std::move(data()[_head]);
+            pop_head();
+            return true;
+        }
+
+        /**
+         * @brief Funzione che rimuove l'elemento in testa spostandolo
+         * nel valore di ritorno, senza lanciare eccezioni se la coda è vuota
+         *
+         * @return std::optional<T> elemento rimosso, vuoto se la coda è vuota
+         */
+        std::optional<T> try_pop(){
+            if(is_empty())
+                return std::nullopt;
+            std::optional<T> value(std::move(data()[_head]));
+            pop_head();
+            return value;
+        }
+
+        /**
+         * @brief Funzione che ritorna la testa della coda senza lanciare eccezioni
+         *
+         * @return T* puntatore alla testa, nullptr se la coda è vuota
+         */
+        constexpr T* try_front() noexcept{
+            return is_empty() ? nullptr : data() + _head;
+        }
+
+        /**
+         * @brief Funzione che ritorna la testa della coda senza lanciare eccezioni
+         *
+         * @return const T* puntatore alla testa, nullptr se la coda è vuota
+         */
+        constexpr const T* try_front() const noexcept{
+            return is_empty() ? nullptr : data() + _head;
+        }
+
+        /**
+         * @brief Funzione che ritorna la coda della coda senza lanciare eccezioni
+         *
+         * @return T* puntatore alla coda, nullptr se la coda è vuota
+         */
+        constexpr T* try_back() noexcept{
+            return is_empty() ? nullptr : data() + slot(_stored_elements - 1);
+        }
+
+        /**
+         * @brief Funzione che ritorna la coda della coda senza lanciare eccezioni
+         *
+         * @return const T* puntatore alla coda, nullptr se la coda è vuota
+         */
+        constexpr const T* try_back() const noexcept{
+            return is_empty() ? nullptr : data() + slot(_stored_elements - 1);
+        }
+
+        /**
+         * @brief Funzione che accoda gli elementi della sequenza [first, last)
+         * secondo la logica FIFO e Overflow (come cbuffer::enqueue_range).
+         * Per iteratori forward la scrittura avviene in al più due segmenti
+         * contigui, per iteratori di input elemento per elemento.
+         *
+         * @tparam It tipo dell'iteratore (il valore deve essere convertibile a T)
+         * @param first iteratore di inizio
+         * @param last iteratore di fine
+         * @return unsigned int numero di elementi della sequenza accodati
+         */
+        template<typename It> constexpr unsigned int enqueue_range(It first, It last){
+            typedef typename std::iterator_traits<It>::iterator_category category;
+            if constexpr(std::is_base_of<std::forward_iterator_tag, category>::value){
+                unsigned int n = static_cast<unsigned int>(std::distance(first, last));
+                if constexpr(rejects){
+                    unsigned int free = std::min(n, N - _stored_elements);
+                    construct_segments(first, free);
+                    return free;
+                }else{
+                    unsigned int accepted = n;
+                    if(n > N){ // restano solo gli ultimi N elementi
+                        std::advance(first, n - N);
+                        n = N;
+                    }
+                    unsigned int free = std::min(n, N - _stored_elements);
+                    construct_segments(first, free);
+                    assign_segments(first, n - free); // coda piena: sovrascrivo i più vecchi
+                    return accepted;
+                }
+            }else{
+                unsigned int accepted = 0;
+                for(; first != last && push(static_cast<T>(*first)); ++first)
+                    accepted++;
+                return accepted;
+            }
+        }
+
+        /**
+         * @brief Funzione che rimuove fino a n elementi dalla testa spostandoli
+         * nella sequenza che inizia da out. La lettura avviene in al più due
+         * segmenti contigui.
+         *
+         * @tparam OutputIt tipo dell'iteratore di output
+         * @param out iteratore di inizio della sequenza di output
+         * @param n numero massimo di elementi da rimuovere
+         * @return unsigned int numero di elementi effettivamente rimossi (0 se la coda è vuota)
+         * @post _stored_elements = _stored_elements - min(n, _stored_elements)
+         */
+        template<typename OutputIt> constexpr unsigned int dequeue_into(OutputIt out, unsigned int n){
+            n = std::min(n, _stored_elements);
+            unsigned int first = std::min(n, N - _head);
+            for(unsigned int i = 0; i < first; ++i, ++out)
+                *out = std::move(data()[_head + i]);
+            for(unsigned int i = 0; i < n - first; ++i, ++out)
+                *out = std::move(data()[i]);
+            destroy(_head, first);
+            destroy(0, n - first);
+            _head = slot(n);
+            _stored_elements -= n;
+            return n;
+        }
+
+        typedef std::pair<T*, unsigned int> array_range; ///< segmento contiguo (puntatore, lunghezza)
+        typedef std::pair<const T*, unsigned int> const_array_range; ///< segmento contiguo costante (puntatore, lunghezza)
+
+        /**
+         * @brief Funzione che ritorna il primo segmento contiguo dei dati:
+         * dalla testa fino alla fine dell'array (o fino alla coda se la
+         * coda non è circolare)
+         *
+         * @return array_range puntatore alla testa e numero di elementi del segmento
+         */
+        array_range array_one(){
+            return array_range(data() + _head, std::min(_stored_elements, N - _head));
+        }
+
+        /**
+         * @brief Funzione che ritorna il primo segmento contiguo dei dati
+         *
+         * @return const_array_range puntatore alla testa e numero di elementi del segmento
+         */
+        const_array_range array_one() const{
+            return const_array_range(data() + _head, std::min(_stored_elements, N - _head));
+        }
+
+        /**
+         * @brief Funzione che ritorna il secondo segmento contiguo dei dati:
+         * dall'inizio dell'array fino alla coda. Il segmento è vuoto
+         * se la coda non è circolare.
+         *
+         * @return array_range puntatore all'inizio dell'array e numero di elementi del segmento
+         */
+        array_range array_two(){
+            return array_range(data(), _stored_elements - std::min(_stored_elements, N - _head));
+        }
+
+        /**
+         * @brief Funzione che ritorna il secondo segmento contiguo dei dati
+         *
+         * @return const_array_range puntatore all'inizio dell'array e numero di elementi del segmento
+         */
+        const_array_range array_two() const{
+            return const_array_range(data(), _stored_elements - std::min(_stored_elements, N - _head));
+        }
+
+        /**
+         * @brief Funzione che chiama f su ogni segmento contiguo non vuoto
+         * dei dati, in ordine FIFO (al più due chiamate)
+         *
+         * @tparam F tipo della funzione, invocabile come f(T *first, T *last)
+         * @param f funzione da applicare ai segmenti
+         * @return F la funzione f dopo le chiamate
+         */
+        template<typename F> F for_each_segment(F f){
+            array_range one = array_one(), two = array_two();
+            if(one.second > 0)
+                f(one.first, one.first + one.second);
+            if(two.second > 0)
+                f(two.first, two.first + two.second);
+            return f;
+        }
+
+        /**
+         * @brief Funzione che chiama f su ogni segmento contiguo non vuoto
+         * dei dati, in ordine FIFO (al più due chiamate)
+         *
+         * @tparam F tipo della funzione, invocabile come f(const T *first, const T *last)
+         * @param f funzione da applicare ai segmenti
+         * @return F la funzione f dopo le chiamate
+         */
+        template<typename F> F for_each_segment(F f) const{
+            const_array_range one = array_one(), two = array_two();
+            if(one.second > 0)
+                f(one.first, one.first + one.second);
+            if(two.second > 0)
+                f(two.first, two.first + two.second);
+            return f;
+        }
+
+        /**
+         * @brief Funzione che ruota in loco i dati in modo che la testa si trovi
+         * all'inizio dell'array e tutti gli elementi siano in un unico segmento
+         * contiguo. Se i dati sono già contigui non viene spostato nulla.
+         *
+         * @return array_range puntatore alla testa e numero di elementi salvati
+         * @post array_two().second == 0
+         */
+        array_range linearize(){
+            array_range one = array_one();
+            unsigned int second = _stored_elements - one.second;
+            if(second == 0)
+                return one;
+
+            //sposto il primo segmento subito dopo il secondo, occupando gli slot liberi
+            T *dst = data() + second;
+            if(dst != one.first){
+                for(unsigned int i = 0; i < one.second; ++i){
+                    construct(second + i, std::move(one.first[i]));
+                    destroy(_head + i);
+                }
+            }
+            //[secondo segmento | primo segmento] -> [primo segmento | secondo segmento]
+            std::rotate(data(), dst, data() + _stored_elements);
+            _head = 0;
+            return array_range(data(), _stored_elements);
+        }
+
+        /**
+         * @brief Funzione che ritorna la testa della coda
+         *
+         * @return T& riferimento della testa
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        constexpr T& head(){
+            if(is_empty())
+                throw_empty("Cannot get the head from an empty queue");
+            return data()[_head];
+        }
+
+        /**
+         * @brief Funzione che ritorna la testa della coda
+         *
+         * @return const T& riferimento della testa
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        constexpr const T& head() const{
+            if(is_empty())
+                throw_empty("Cannot get the head from an empty queue");
+            return data()[_head];
+        }
+
+        /**
+         * @brief Funzione che ritorna la coda della coda
+         *
+         * @return T& riferimento della coda
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        constexpr T& tail(){
+            if(is_empty())
+                throw_empty("Cannot get the tail from an empty queue");
+            return data()[slot(_stored_elements - 1)];
+        }
+
+        /**
+         * @brief Funzione che ritorna la coda della coda
+         *
+         * @return const T& riferimento della coda
+         * @throw empty_queue_exception eccezione lanciata nel caso la coda fosse vuota
+         */
+        constexpr const T& tail() const{
+            if(is_empty())
+                throw_empty("Cannot get the tail from an empty queue");
+            return data()[slot(_stored_elements - 1)];
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è piena
+         *
+         * @return true se la coda è piena
+         * @return false se la coda non è piena
+         */
+        constexpr bool is_full() const noexcept{
+            return _stored_elements == N;
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la coda è vuota
+         *
+         * @return true se la coda è vuota
+         * @return false se la coda non è vuota
+         */
+        constexpr bool is_empty() const noexcept{
+            return _stored_elements == 0;
+        }
+
+        /**
+         * @brief Funzione che ritorna la dimensione massima della coda
+         *
+         * @return unsigned int N
+         */
+        static constexpr unsigned int size() noexcept{
+            return N;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di elementi salvati
+         * nella coda
+         *
+         * @return unsigned int numero di elementi salvati
+         */
+        constexpr unsigned int stored_elements() const noexcept{
+            return _stored_elements;
+        }
+
+        /**
+         * @brief Operatore di stream (stesso formato di cbuffer)
+         *
+         * @param os stream di output
+         * @param b static_cbuffer da spedire sullo stream
+         * @return std::ostream& reference dello stream di output
+         */
+        friend std::ostream& operator<<(std::ostream &os, const static_cbuffer &b){
+            if(!b.is_empty()){
+                unsigned int tail = b.slot(b._stored_elements - 1);
+                os<<"Head: " <<b._head <<" - value: ["<< b.data()[b._head] <<"] "<<std::endl;
+                os<<"Tail: "<<tail<<" - value: ["<< b.data()[tail] <<"] "<<std::endl;
+                os<<"Size: "<<b.size()<<std::endl;
+                os<<"Stored elements: "<<b.stored_elements()<<std::endl;
+                os<<"[ ";
+                for(unsigned int i = 0; i < b._stored_elements; ++i)
+                    os<<b.data()[b.slot(i)]<<" ";
+                for(unsigned int i = b._stored_elements; i < N; ++i)
+                    os<<"# ";
+                os<<"]";
+            }else
+                os<<"[]";
+            return os;
+        }
+
+        /**
+         * @brief Operator[]
+         *
+         * @param index indice
+         * @return T& riferimento dell'elemento nella posizione index
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
+         */
+        constexpr T& operator[](int index){
+            if(index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
+            return data()[slot(index)];
+        }
+
+        /**
+         * @brief Operator[] const
+         *
+         * @param index indice
+         * @return const T& riferimento dell'elemento nella posizione index
+         * @throw std::out_of_range eccezione lanciata in caso di indice fuori range (index >= stored_elements())
+         */
+        constexpr const T& operator[](int index) const{
+            if(index < 0 || static_cast<unsigned int>(index) >= _stored_elements)
+                throw_out_of_range();
+            return data()[slot(index)];
+        }
+
+        typedef cbuffer_iterator<static_cbuffer, T> iterator; ///< iteratore sui dati (lo stesso di cbuffer)
+        typedef cbuffer_iterator<const static_cbuffer, const T> const_iterator; ///< iteratore costante sui dati
+
+        /**
+         * @brief Iteratore di inizio
+         *
+         * @return iterator che punta alla testa
+         */
+        constexpr iterator begin(){
+            return iterator(this, 0);
+        }
+
+        /**
+         * @brief Iteratore fine
+         *
+         * @return iterator che punta dopo la coda
+         */
+        constexpr iterator end(){
+            return iterator(this, _stored_elements);
+        }
+
+        /**
+         * @brief Iteratore di inizio
+         *
+         * @return const_iterator che punta alla testa
+         */
+        constexpr const_iterator begin() const{
+            return const_iterator(this, 0);
+        }
+
+        /**
+         * @brief Iteratore fine
+         *
+         * @return const_iterator che punta dopo la coda
+         */
+        constexpr const_iterator end() const{
+            return const_iterator(this, _stored_elements);
+        }
+};
+
+#endif
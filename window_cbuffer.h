@@ -0,0 +1,268 @@
+#ifndef WINDOW_CBUFFER_H
+#define WINDOW_CBUFFER_H
+#include <type_traits> // std::is_arithmetic
+#include <utility> // std::pair
+#include "cbuffer.h"
+#include "empty_queue_exception.h"
+/**
+ * @brief Classe window_cbuffer
+ *
+ * La classe implementa una finestra scorrevole sugli ultimi size()
+ * valori accodati: quando la finestra è piena ogni enqueue sovrascrive
+ * il valore più vecchio, come cbuffer. A ogni inserimento e rimozione
+ * vengono aggiornati in O(1) ammortizzato somma e somma dei quadrati
+ * (per media e varianza) e due code monotone per minimo e massimo,
+ * quindi tutte le statistiche della finestra si leggono in O(1)
+ * indipendentemente dalla capacità.
+ *
+ * Le code monotone sono cbuffer di coppie (numero d'ordine, valore):
+ * la coda del minimo contiene valori crescenti dalla testa alla coda,
+ * quella del massimo valori decrescenti. Un valore che non potrà mai
+ * diventare minimo (massimo) viene scartato appena ne arriva uno più
+ * piccolo (grande). Non servono allocazioni dopo la costruzione.
+ *
+ * Somma e somma dei quadrati sono accumulate in double: per T intero
+ * sono esatte finché restano sotto 2^53, per T in virgola mobile possono
+ * accumulare errori di arrotondamento su flussi molto lunghi
+ * (recompute() le ricalcola dai valori nella finestra).
+ *
+ * La lunghezza della finestra è quella passata al costruttore anche con
+ * pow2_index: le code sottostanti hanno la capacità arrotondata alla
+ * potenza di due successiva, ma la finestra esce il valore più vecchio
+ * appena contiene size() valori.
+ *
+ * @tparam T Tipo aritmetico dei valori
+ * @tparam Index Politica di indicizzazione (modulo_index o pow2_index)
+ */
+template<typename T, typename Index = modulo_index> class window_cbuffer{
+
+    static_assert(std::is_arithmetic<T>::value, "window_cbuffer requires an arithmetic type");
+
+    typedef std::pair<unsigned long long, T> entry; ///< numero d'ordine e valore
+
+    cbuffer<T, Index> _window; ///< valori nella finestra
+    cbuffer<entry, Index> _min; ///< candidati minimo (valori crescenti)
+    cbuffer<entry, Index> _max; ///< candidati massimo (valori decrescenti)
+    unsigned int _length; ///< numero di valori nella finestra (con pow2_index minore o uguale a _window.size())
+    unsigned long long _count; ///< numero d'ordine del prossimo valore accodato
+    double _sum; ///< somma dei valori nella finestra
+    double _sum_of_squares; ///< somma dei quadrati dei valori nella finestra
+
+    /**
+     * @brief Funzione di supporto che aggiorna le statistiche per l'uscita
+     * del valore in testa alla finestra (da chiamare prima di rimuoverlo)
+     *
+     * @param value valore in testa
+     */
+    void evict(const T &value){
+        unsigned long long sequence = _count - _window.stored_elements();
+        _sum -= value;
+        _sum_of_squares -= static_cast<double>(value) * value;
+        if(_min.head().first == sequence)
+            _min.pop();
+        if(_max.head().first == sequence)
+            _max.pop();
+    }
+
+    public:
+        /**
+         * @brief Costruttore di default
+         *
+         */
+        window_cbuffer(): _length(0), _count(0), _sum(0), _sum_of_squares(0){}
+
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param size numero di valori nella finestra
+         * @throw negative_queue_size_exception eccezione lanciata in caso di dimensione strettamente negativa
+         * @throw std::bad_alloc eccezione lanciata in caso di allocazione non riuscita
+         */
+        explicit window_cbuffer(int size): _window(size), _min(size), _max(size),
+            _length(size), _count(0), _sum(0), _sum_of_squares(0){}
+
+        /**
+         * @brief Funzione che accoda value. Se la finestra è piena il
+         * valore più vecchio esce dalla finestra e viene sovrascritto.
+         *
+         * @param value valore da inserire
+         * @throw empty_queue_exception eccezione lanciata in caso di aggiunta su una finestra con size pari a 0
+         */
+        void enqueue(const T &value){
+            if(_length == 0)
+                throw empty_queue_exception("Cannot add an element in an empty queue");
+            if(is_full()){
+                evict(_window.head());
+                if(!_window.is_full()) // capacità arrotondata da pow2_index: la testa va rimossa
+                    _window.pop();
+            }
+            _window.enqueue(value); // sovrascrive la testa se la finestra riempie la capacità
+
+            _sum += value;
+            _sum_of_squares += static_cast<double>(value) * value;
+            while(!_min.is_empty() && !(_min.tail().second < value))
+                _min.pop_tail();
+            _min.enqueue(entry(_count, value));
+            while(!_max.is_empty() && !(value < _max.tail().second))
+                _max.pop_tail();
+            _max.enqueue(entry(_count, value));
+            ++_count;
+        }
+
+        /**
+         * @brief Funzione che rimuove il valore più vecchio della finestra
+         *
+         * @return T valore rimosso
+         * @throw empty_queue_exception eccezione lanciata in caso di rimozione da una finestra vuota
+         */
+        T pop(){
+            if(is_empty())
+                throw empty_queue_exception("Cannot remove an element from an empty queue");
+            evict(_window.head());
+            return _window.pop();
+        }
+
+        /**
+         * @brief Funzione che svuota la finestra
+         *
+         */
+        void clear(){
+            _window.clear();
+            _min.clear();
+            _max.clear();
+            _sum = 0;
+            _sum_of_squares = 0;
+        }
+
+        /**
+         * @brief Funzione che ricalcola somma e somma dei quadrati dai
+         * valori nella finestra, eliminando l'errore di arrotondamento
+         * accumulato. Costo O(stored_elements()).
+         *
+         */
+        void recompute(){
+            _sum = 0;
+            _sum_of_squares = 0;
+            for(const T &value : _window){
+                _sum += value;
+                _sum_of_squares += static_cast<double>(value) * value;
+            }
+        }
+
+        /**
+         * @brief Funzione che ritorna la somma dei valori nella finestra
+         *
+         * @return double somma (0 se la finestra è vuota)
+         */
+        double sum() const{
+            return _sum;
+        }
+
+        /**
+         * @brief Funzione che ritorna la somma dei quadrati dei valori nella finestra
+         *
+         * @return double somma dei quadrati (0 se la finestra è vuota)
+         */
+        double sum_of_squares() const{
+            return _sum_of_squares;
+        }
+
+        /**
+         * @brief Funzione che ritorna la media dei valori nella finestra
+         *
+         * @return double media
+         * @throw empty_queue_exception eccezione lanciata nel caso la finestra fosse vuota
+         */
+        double mean() const{
+            if(is_empty())
+                throw empty_queue_exception("Cannot compute the mean of an empty queue");
+            return _sum / _window.stored_elements();
+        }
+
+        /**
+         * @brief Funzione che ritorna la varianza (della popolazione)
+         * dei valori nella finestra
+         *
+         * @return double varianza, mai negativa
+         * @throw empty_queue_exception eccezione lanciata nel caso la finestra fosse vuota
+         */
+        double variance() const{
+            double m = mean();
+            double v = _sum_of_squares / _window.stored_elements() - m * m;
+            return v > 0 ? v : 0; // l'arrotondamento può renderla appena negativa
+        }
+
+        /**
+         * @brief Funzione che ritorna il minimo dei valori nella finestra
+         *
+         * @return T valore minimo
+         * @throw empty_queue_exception eccezione lanciata nel caso la finestra fosse vuota
+         */
+        T min() const{
+            if(is_empty())
+                throw empty_queue_exception("Cannot compute the minimum of an empty queue");
+            return _min.head().second;
+        }
+
+        /**
+         * @brief Funzione che ritorna il massimo dei valori nella finestra
+         *
+         * @return T valore massimo
+         * @throw empty_queue_exception eccezione lanciata nel caso la finestra fosse vuota
+         */
+        T max() const{
+            if(is_empty())
+                throw empty_queue_exception("Cannot compute the maximum of an empty queue");
+            return _max.head().second;
+        }
+
+        /**
+         * @brief Funzione che ritorna i valori nella finestra (in sola lettura)
+         *
+         * @return const cbuffer<T, Index>& valori dal più vecchio al più recente
+         * (con pow2_index la sua capacità può essere maggiore di size())
+         */
+        const cbuffer<T, Index>& window() const{
+            return _window;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero massimo di valori nella finestra
+         *
+         * @return unsigned int dimensione della finestra
+         */
+        unsigned int size() const{
+            return _length;
+        }
+
+        /**
+         * @brief Funzione che ritorna il numero di valori nella finestra
+         *
+         * @return unsigned int numero di valori
+         */
+        unsigned int stored_elements() const{
+            return _window.stored_elements();
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la finestra è vuota
+         *
+         * @return true se la finestra è vuota
+         * @return false altrimenti
+         */
+        bool is_empty() const{
+            return _window.is_empty();
+        }
+
+        /**
+         * @brief Funzione che ritorna true se la finestra è piena
+         *
+         * @return true se la finestra è piena
+         * @return false altrimenti
+         */
+        bool is_full() const{
+            return _window.stored_elements() == _length;
+        }
+};
+
+#endif